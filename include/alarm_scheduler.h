@@ -3,16 +3,33 @@
 #include <RTClib.h>
 #include "config.h"
 #include "debug.h"
+#include "dht22.h"
 
 // Hygrometer alarm scheduling / failsafe module (DS3231 based)
-// All state private to implementation. Functions are no-ops when RTC absent.
+// All state private to implementation. Without an RTC only the grid
+// (Init / ShouldFire / AdvanceAfterFire) runs, on deadline DL_SAMPLE;
+// the rest are no-ops.
 
 void hygroSchedulerInit(uint32_t startEpoch);           // initialize next alarm grid & anchor elapsed base
-bool hygroSchedulerShouldFire(uint32_t nowEpoch);       // true if DS3231 alarm fired or time >= next epoch
+bool hygroSchedulerShouldFire(uint32_t nowEpoch);       // true if sample alarm fired (status from this wake's time read) or time >= next epoch
+bool hygroSchedulerPrewarmDue(uint32_t nowEpoch);       // true if the pre-warm alarm (grid - DHT_PREWARM_SEC) fired
+void hygroSchedulerArmSample();                         // after pre-warm: reprogram Alarm1 for the grid second itself
 void hygroSchedulerAdvanceAfterFire(uint32_t nowEpoch); // advance next epoch and reprogram alarm (call after fire detection, before sampling)
 void hygroSchedulerMarkSample(uint32_t nowEpoch);       // mark that a sample was just taken (updates failsafe bookkeeping)
-void hygroSchedulerSanity(uint32_t nowEpoch);           // realign if alarm scheduled too far ahead
-bool hygroSchedulerFailsafeCheck(uint32_t nowEpoch);    // reschedule if silence > failsafe window; returns true if rescheduled
+void hygroSchedulerSanity(uint32_t nowEpoch);           // realign if alarm scheduled too far ahead; retry a failed alarm write
+bool hygroSchedulerFailsafeCheck(uint32_t nowEpoch);    // reschedule if Alarm2 backstop fired or silence > window; true if rescheduled
 
 uint32_t hygroSchedulerNextEpoch(); // current next target epoch (0 if uninitialized / no RTC)
 uint32_t hygroSchedulerBaseEpoch(); // anchored elapsed base epoch (0 if not set)
+
+// Energy policy: leave the DHT powered between samples (no pre-warm stage)
+bool hygroSchedulerKeepSensorPowered();
+
+// Adaptive interval (ADAPT_INTERVAL): feed each reading; stable readings
+// double the interval, a step change snaps back to UPDATE_INTERVAL_SEC.
+void hygroSchedulerNoteReading(int16_t tc10, int16_t rh10); // 0.1 units, DHT22_NO_READING = failed
+uint32_t hygroSchedulerIntervalSec(); // current sample interval (multiple of UPDATE_INTERVAL_SEC)
+
+// Power profile changed the interval floor: re-grid the pending sample
+// (hygro mode only; the elapsed anchor is kept)
+void hygroSchedulerProfileChanged();
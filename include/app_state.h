@@ -1,6 +1,8 @@
 #pragma once
 #include <Arduino.h>
 #include <RTClib.h>
+#include "timebase.h"
+#include "deadline.h"
 
 // Forward enum (defined in main or separate header if split later)
 #ifndef DEVICE_MODE_ENUM_DEFINED
@@ -20,27 +22,23 @@ struct AppState
     DateTime startTimeRTC;
     DateTime modeStartRTC;
 
-    // Millis-based fallbacks / counters
-    unsigned long startMillis = 0;
-    unsigned long modeStartMillis = 0;
-    unsigned long lastHygroUpdateMillis = 0;
-    unsigned long modeSleepSecondsAccum = 0;
-    unsigned long softSeconds = 0; // clock mode w/o RTC
-    unsigned long sysSeconds = 0;  // coarse seconds for backlight when no RTC
+    // Monotonic-clock anchors (deadlineNow(), includes sleep) for the no-RTC path
+    unsigned long startMs = 0;     // boot: no-RTC clock display counts from here
+    unsigned long modeStartMs = 0; // mode entry: no-RTC hygro elapsed display
 
-    // PCINT / wake flags (volatile for ISR access)
-    volatile bool switchWake = false;
-    volatile bool tickWake = false;
-    volatile bool serialWake = false;
+    // PCINT pin snapshots (wake events themselves go through event_queue)
     volatile uint8_t lastPinsD = 0;
 
+    // SQW-counted epoch (advanced in ISR on 1 Hz rising edges, see timebase)
+    volatile uint32_t sqwEpoch = 0;
+    volatile bool sqwCounting = false;
+    volatile uint8_t sqwEdges = 0; // raw count of those edges, never reseeded (sleep credit)
+
     // Backlight button PCINT (B port)
-    volatile bool blButtonWake = false;
     volatile uint8_t lastPinsB = 0;
 
-    // Backlight / serial keep-awake bookkeeping
+    // Backlight button debounce (serial keep-awake is deadline DL_SERIAL_AWAKE)
     unsigned long blLastHandledMs = 0;
-    unsigned long serialAwakeUntil = 0;
 
     // Mode switch debounce bookkeeping
     unsigned long lastModeReadMs = 0;
@@ -50,15 +48,11 @@ struct AppState
 
 extern AppState g_app; // defined in main.cpp
 
-// Inline helpers centralizing time and wake flag operations
+// Inline helpers centralizing time operations
 extern RTC_DS3231 rtc; // provided by main.cpp
 
 inline uint32_t currentSeconds()
 {
-    return g_app.rtcAvailable ? rtc.now().unixtime() : g_app.sysSeconds;
+    return g_app.rtcAvailable ? timebaseNow() : deadlineNow() / 1000UL;
 }
 
-inline void appClearWakeFlags()
-{
-    g_app.switchWake = g_app.tickWake = g_app.serialWake = false;
-}
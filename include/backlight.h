@@ -7,6 +7,6 @@
 void backlightInit();
 void backlightOn();
 void backlightOff();
-void backlightMaintain(uint32_t nowSeconds); // auto-off check
+void backlightMaintain(); // auto-off once DL_BACKLIGHT is due
 bool backlightIsActive();
-uint32_t backlightStartSeconds();
+uint32_t backlightOnMs(); // cumulative lit time (deadlineNow ms, wraps)
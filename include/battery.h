@@ -1,64 +1,38 @@
 #pragma once
 #include <Arduino.h>
+#include "config.h"
 #include "debug.h"
 #include "pins.h"
 
-// Divider values
-static const float Rtop = 180000.0f;
-static const float Rbot = 330000.0f;
-static const float VBAT_CAL = 0.9975308642f;
+// Divider values; VBAT_CAL = 0.9975308642 as parts per million
+static const uint32_t Rtop = 180000UL;
+static const uint32_t Rbot = 330000UL;
+static const uint32_t VBAT_CAL_PPM = 997531UL;
+// Pin-to-battery factor (Rtop + Rbot) / Rbot * VBAT_CAL in Q16, folded at compile time
+static const uint32_t VBAT_SCALE_Q16 =
+    (uint32_t)(((uint64_t)(Rtop + Rbot) * VBAT_CAL_PPM * 65536ULL + (uint64_t)Rbot * 500000ULL) /
+               ((uint64_t)Rbot * 1000000ULL));
 
-// Battery thresholds
-static const float VBAT_FULL_TH = 4.00f;
-static const float VBAT_MED_TH = 3.70f;
-static const float VBAT_LOW_TH = 3.50f;
+// Battery thresholds (mV)
+static const uint16_t VBAT_FULL_MV = 4000;
+static const uint16_t VBAT_MED_MV = 3700;
+static const uint16_t VBAT_LOW_MV = 3500;
 
-inline float readVccCalibrated()
-{
-    ADMUX = _BV(REFS0) | _BV(MUX3) | _BV(MUX2) | _BV(MUX1); // 1.1V internal ref
-    delay(2);
-    ADCSRA |= _BV(ADSC);
-    while (bit_is_set(ADCSRA, ADSC))
-        ;
-    uint16_t raw = ADC;
-    return (1.1f * 1023.0f) / (float)raw; // Vcc in volts
-}
-
-inline float readBatteryVolts()
-{
-    (void)analogRead(VBAT_PIN);
-    delay(3);
-    long acc = 0;
-    const int N = 8;
-    for (int i = 0; i < N; i++)
-    {
-        acc += analogRead(VBAT_PIN);
-        delay(3);
-    }
-    float adc = acc / float(N);
-    float vcc = readVccCalibrated();
-    float vA0 = (adc * vcc) / 1023.0f;
-    float vb = vA0 * (Rtop + Rbot) / Rbot;
-    float out = vb * VBAT_CAL;
-    DBG_PRINT(F("[BAT] adc="));
-    DBG_PRINT(adc);
-    DBG_PRINT(F(" vcc="));
-    DBG_PRINT(vcc, 3);
-    DBG_PRINT(F(" vA0="));
-    DBG_PRINT(vA0, 3);
-    DBG_PRINT(F(" Vbat="));
-    DBG_PRINT(out, 3);
-    DBG_PRINTLN(F("V"));
-    return out;
-}
+// Cached battery subsystem. Each conversion runs in ADC noise-reduction
+// sleep (CPU halted); results are folded into a filtered millivolt value
+// that callers read instead of touching the ADC.
+void batteryRefresh();                           // measure now and update the cache
+void batteryMaintain(uint32_t nowSeconds);       // refresh when older than BATTERY_REFRESH_SEC
+uint16_t batteryForDisplay(uint32_t nowSeconds); // maintain (or refresh, see config) and return mV
+uint16_t batteryMillivolts();                    // cached, filtered (0 until first refresh)
 
-inline char batteryFlag(float v)
+inline char batteryFlag(uint16_t mv)
 {
-    if (v >= VBAT_FULL_TH)
+    if (mv >= VBAT_FULL_MV)
         return 'F';
-    if (v >= VBAT_MED_TH)
+    if (mv >= VBAT_MED_MV)
         return 'M';
-    if (v >= VBAT_LOW_TH)
+    if (mv >= VBAT_LOW_MV)
         return 'L';
     return '!';
 }
@@ -3,13 +3,85 @@
 // ---- Feature / Debug Toggles ----
 #define ENABLE_SERIAL_RTC_CMDS 1
 #define ENABLE_SERIAL_DEBUG 0 // Set 0 to save power once done debugging
+#define ENABLE_LCD_BENCH 0    // Boot-time LiquidCrystal vs fast driver benchmark
+#define LOG_RING_SIZE 128     // debug log buffer (bytes, power of two; only with ENABLE_SERIAL_DEBUG)
+#define ENABLE_WAKE_STATS 1   // per-source wake / awake-time counters (ST command)
+#define ENABLE_CYCLE_PROFILER 0 // Timer1 cycle counts per hot function (PF command; keeps Timer1 running)
+#define ENABLE_RAM_MONITOR 1  // stack painted at boot, RAM low-water mark via the RM command
 
 // ---- Timing ----
 #define UPDATE_INTERVAL_SEC 30      // Hygro sample period (s)
 #define DHT_SETTLE_MS 1800          // DHT power-up settle
+#define DHT_RETRY_MS 400            // Gap before the single retry after a failed read
 #define BACKLIGHT_DURATION_SEC 10UL // Backlight auto-off
 #define BL_DEBOUNCE_MS 150UL        // Backlight button debounce
 
+// ---- Adaptive Sampling ----
+// While readings stay within the deltas below for ADAPT_STABLE_SAMPLES
+// samples in a row the interval doubles (UPDATE_INTERVAL_SEC * 2^k, capped
+// at UPDATE_INTERVAL_MAX_SEC); any larger step snaps back to the base rate.
+// Every interval is a multiple of the base, so samples stay on its grid.
+#define ADAPT_INTERVAL 1
+#define UPDATE_INTERVAL_MAX_SEC 600UL // longest interval (rounded down to base * 2^k)
+#define ADAPT_DELTA_T_C10 3           // |dT| per sample counted as stable (0.1 degC)
+#define ADAPT_DELTA_RH10 20           // |dRH| per sample counted as stable (0.1 %RH)
+#define ADAPT_STABLE_SAMPLES 2        // stable samples before the next doubling
+
+// ---- DHT Power Policy ----
+// Pre-warm lead: the sensor is powered this many seconds before the grid
+// second so the reading itself lands on the grid.
+#define DHT_PREWARM_SEC ((DHT_SETTLE_MS + 999) / 1000)
+// Keep the DHT powered between samples when standby for one interval costs
+// less than a settle window: interval * I_standby <= settle * I_settle.
+#define DHT_STANDBY_UA 50UL  // AM2302 standby current
+#define DHT_SETTLE_UA 1000UL // average draw during power-up settle
+#define DHT_KEEP_POWERED_MAX_SEC ((DHT_SETTLE_MS * DHT_SETTLE_UA) / (1000UL * DHT_STANDBY_UA))
+
+// ---- Battery ----
+#define BATTERY_REFRESH_SEC 600UL      // Cached battery value refresh cadence
+#define BATTERY_REFRESH_ON_DISPLAY 0   // 1 = re-measure on every display update
+
+// ---- Clock Mode ----
+// 1 = wake once a minute (DS3231 Alarm2) and hide seconds; 1 Hz SQW with
+// seconds only while the backlight is on or the serial window is open.
+#define CLOCK_MINUTE_PROFILE 1
+
+// ---- Power Profiles (see power_profile.h) ----
+#define POWER_PROFILE_HYST_MV 50      // recovery margin above an entry threshold
+#define VBAT_HIBERNATE_MV 3350        // below: LCD off, sampling suspended
+#define PP_LOW_MIN_INTERVAL_SEC 120UL // 'L' and below: hygro interval floor
+#define PP_LOW_BACKLIGHT_SEC 4UL      // 'L' and below: backlight auto-off
+
+// ---- Runtime Estimate (see runtime_estimate.h) ----
+// Per-state supply currents for the energy model. Rough figures for this
+// board: measure yours and override them with -D build flags.
+#ifndef EST_BATTERY_MAH
+#define EST_BATTERY_MAH 2000UL // usable capacity down to VBAT_HIBERNATE_MV
+#endif
+#ifndef EST_I_SLEEP_UA
+#define EST_I_SLEEP_UA 1200UL // powered down: LCD logic, DS3231, divider, regulator
+#endif
+#ifndef EST_I_AWAKE_UA
+#define EST_I_AWAKE_UA 7000UL // MCU running (or idling in the serial window) on top of sleep
+#endif
+#ifndef EST_I_BACKLIGHT_UA
+#define EST_I_BACKLIGHT_UA 15000UL // LED backlight on top of everything else
+#endif
+#define EST_AVG_TAU_MIN 1440UL  // averaging time constant of the model current
+#define EST_TREND_STEP_MIN 240UL // voltage trend: one point per step
+#define EST_TREND_POINTS 12      // ring size (12 x 4 h = 2 days)
+#define EST_TREND_MIN_POINTS 4   // fewer points: model only
+
+// ---- CPU Clock (see cpu_clock.h) ----
+// Core clock divider, as a power of two, for I/O-bound awake phases. The
+// DHT bit-bang and anything needing the USART always run at full F_CPU.
+#define CPU_CLOCK_SCALING 1
+#define CPU_SHIFT_LCD 4 // 16 MHz / 16 = 1 MHz: LCD writes are paced by the 37 us execution time
+#define CPU_SHIFT_I2C 2 // 16 MHz / 4 = 4 MHz: SCL tops out at 250 kHz (TWBR 0)
+
+// ---- Time Base ----
+#define TIMEBASE_RESYNC_SEC 3600UL // Re-seed the SQW-counted epoch from the DS3231
+
 // ---- Alarm / Failsafe ----
 #define ENABLE_ALARM_FAILSAFE 1
 #define ALARM_FAILSAFE_SEC 120 // Silence window before forced reschedule
@@ -19,6 +91,3 @@
 #define MODE_DEBOUNCE_MS 80UL
 #define MODE_REENTRY_GUARD_MS 300UL
 #define MODE_SWITCH_SUPPRESS_MS 120UL // mask switch PCINT after mode change
-
-// ---- Sensor Config ----
-#define DHTTYPE DHT22
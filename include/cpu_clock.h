@@ -0,0 +1,20 @@
+#pragma once
+#include <Arduino.h>
+
+// Core clock prescaling (CLKPR) for I/O-bound awake phases.
+// Timer0 is divided along with the core, so millis()/micros() slow down by
+// the same factor; the time they miss is accounted here and cpuClockMillis()
+// is the corrected awake clock (deadline, timebase and the DHT sampler use
+// it). delay()/delayMicroseconds() stretch by the divider too: timing-
+// critical waits inside a divided phase use cpuClockDelayUs().
+//
+// Dividing is refused while the USART is clocked (its baud rate derives
+// from the core clock), so serial windows and debug builds stay at F_CPU.
+
+#define CPU_FULL 0 // shift: F_CPU
+
+uint8_t cpuClockSet(uint8_t shift); // run at F_CPU >> shift; returns the previous shift for restoring
+uint8_t cpuClockShift();            // current divider as a shift
+uint32_t cpuClockMillis();          // millis() corrected for time spent divided
+uint32_t cpuClockMicros();          // micros() likewise (for differences; wraps)
+void cpuClockDelayUs(uint16_t us);  // delayMicroseconds() in real microseconds at any divider
@@ -0,0 +1,60 @@
+#pragma once
+#include <Arduino.h>
+#include "config.h"
+
+// Timer1 cycle profiler (ENABLE_CYCLE_PROFILER).
+// Timer1 free-runs at clk/1 with an overflow count on top, so a region
+// costs two 32-bit timestamps (wraps after 268 s at 16 MHz). Each region
+// keeps count / min / max / mean in a fixed table; PF dumps it over
+// serial, PF=0 clears it. Counts are CPU cycles: they shrink with the core
+// clock divider (cpu_clock.h) and stop in power-down, so a region that
+// sleeps reports its awake work only. Disabled, PROF_SCOPE is empty and
+// Timer1 stays gated.
+//   void updateClockMode() { PROF_SCOPE(PR_UPDATE_CLOCK); ... }
+
+enum ProfRegion : uint8_t
+{
+    PR_UPDATE_HYGRO = 0, // updateHygroMode
+    PR_UPDATE_CLOCK,     // updateClockMode
+    PR_BATTERY,          // batteryRefresh
+    PR_LCD_PRINT,        // lcdPrint16
+    PR_HYGRO_LINE1,      // buildHygroLine1
+    PR_HYGRO_LINE2,      // buildHygroLine2
+    PR_CLOCK_LINES,      // buildClockLines
+    PR_PROGRAM_ALARM,    // alarm_scheduler programAlarm
+    PR_RTC_READ,         // ds3231ReadTimeStatus
+    PR_TIME_CMDS,        // timeCommandsHandle
+    PR_COUNT
+};
+
+#if ENABLE_CYCLE_PROFILER
+
+void profInit(); // after periphInit(): acquire and start Timer1
+uint32_t profNow();
+void profRecord(ProfRegion r, uint32_t start);
+void profReset();
+void profDump(Print &out);
+
+class ProfScope
+{
+public:
+    explicit ProfScope(ProfRegion r) : r_(r), t0_(profNow()) {}
+    ~ProfScope() { profRecord(r_, t0_); }
+
+private:
+    ProfRegion r_;
+    uint32_t t0_;
+};
+
+#define PROF_CAT2(a, b) a##b
+#define PROF_CAT(a, b) PROF_CAT2(a, b)
+#define PROF_SCOPE(r) ProfScope PROF_CAT(profScope_, __LINE__)(r)
+
+#else
+
+#define PROF_SCOPE(r) \
+    do                \
+    {                 \
+    } while (0)
+
+#endif
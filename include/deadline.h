@@ -0,0 +1,37 @@
+#pragma once
+#include <Arduino.h>
+
+// Deadline table driving the main loop's sleep decision.
+// Each module arms its own slot on a monotonic millisecond clock; the loop
+// sleeps until the earliest armed slot (or untimed, woken by the RTC or a
+// pin change, when none is armed). Fixed slots, no allocation.
+//
+// The monotonic clock is the awake clock (millis() corrected for clock
+// prescaling, cpu_clock.h) plus time credited for power-down sleeps, since
+// millis() stalls while the CPU is powered down.
+
+enum DeadlineId : uint8_t
+{
+    DL_SAMPLE = 0,      // no-RTC hygro sample grid (alarm_scheduler)
+    DL_BACKLIGHT,       // backlight auto-off (backlight)
+    DL_SERIAL_AWAKE,    // serial keep-awake window ends
+    DL_SWITCH_UNMASK,   // slide-switch PCINT suppression ends (modes)
+    DL_CLOCK_TICK,      // no-RTC clock display second
+    DL_ALARM_RETRY,     // hygro alarm write failed: WDT-sliced wake at its target (alarm_scheduler)
+    DL_COUNT
+};
+
+#define DEADLINE_NONE 0xFFFFFFFFUL // deadlineMsToNext(): nothing armed
+
+uint32_t deadlineNow();                       // monotonic ms
+void deadlineCreditSleep(uint32_t ms);        // account power-down time millis() missed
+
+void deadlineSet(DeadlineId id, uint32_t inMs);   // arm relative to now
+void deadlineSetAt(DeadlineId id, uint32_t atMs); // arm at an absolute monotonic time
+void deadlineAdvance(DeadlineId id, uint32_t periodMs); // step by whole periods past now (drift-free grid)
+void deadlineCancel(DeadlineId id);
+bool deadlineArmed(DeadlineId id);
+bool deadlineReached(DeadlineId id); // armed and due (stays armed)
+bool deadlineTake(DeadlineId id);    // armed and due: disarm and return true once
+bool deadlineActive(DeadlineId id);  // armed and not yet due (window still open); disarms once due
+uint32_t deadlineMsToNext();         // ms until the earliest armed slot, 0 if overdue
@@ -1,30 +1,21 @@
 #pragma once
 #include <Arduino.h>
 #include "config.h"
+#include "serial_port.h"
+#include "debug_log.h"
 
 #if ENABLE_SERIAL_DEBUG || ENABLE_SERIAL_RTC_CMDS
-#define DBG_BEGIN(...) Serial.begin(__VA_ARGS__)
-#define DBG_PRINT(...)                 \
+#define DBG_BEGIN(...) uart.begin(__VA_ARGS__)
+#else
+#define DBG_BEGIN(...)
+#endif
+
+// Tokenized debug record: DBG_LOG(LOG_BAT, mv, ...) with an id from
+// log_catalog.h. Arguments are type-checked in every build; the call is
+// compiled out unless ENABLE_SERIAL_DEBUG.
+#define DBG_LOG(id, ...)               \
     do                                 \
     {                                  \
         if (ENABLE_SERIAL_DEBUG)       \
-            Serial.print(__VA_ARGS__); \
-    } while (0)
-#define DBG_PRINTLN(...)                 \
-    do                                   \
-    {                                    \
-        if (ENABLE_SERIAL_DEBUG)         \
-            Serial.println(__VA_ARGS__); \
+            dbgLog(id, ##__VA_ARGS__); \
     } while (0)
-#define DBG_FLUSH()              \
-    do                           \
-    {                            \
-        if (ENABLE_SERIAL_DEBUG) \
-            Serial.flush();      \
-    } while (0)
-#else
-#define DBG_BEGIN(...)
-#define DBG_PRINT(...)
-#define DBG_PRINTLN(...)
-#define DBG_FLUSH()
-#endif
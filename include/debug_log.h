@@ -0,0 +1,79 @@
+#pragma once
+#include <Arduino.h>
+#include "config.h"
+#include "log_catalog.h"
+
+// Deferred, tokenized debug log (defmt style). A call site stores its
+// message id and raw arguments in a RAM ring: nothing is formatted on the
+// target and nothing waits for the UART. dbgLogDrain() hands queued bytes
+// to the USART as its TX ring has room; tools/log_decode.py rebuilds the
+// text from log_catalog.h.
+//
+// Record: LOG_SYNC, id, then each argument little-endian (2 bytes for
+// %u/%d, 4 for %lu/%ld/%t, 1 for %c, length + bytes for %s). A record that
+// does not fit the ring is dropped whole and reported by LOG_DROPPED, and
+// records reach the USART whole, so serial replies fall between them.
+// LOG_BOOT carries LOG_CATALOG_HASH; the decoder warns when a capture was
+// built from a different catalog than the one it reads.
+// Main context only.
+
+#define LOG_SYNC 0x1E     // ASCII RS: never part of the serial command replies
+#define LOG_STR_MAX 16    // %s arguments are truncated to this
+#define LOG_RECORD_MAX 32 // largest record
+
+enum LogId : uint8_t
+{
+#define LOG_ENUM(id, fmt) id,
+    LOG_CATALOG(LOG_ENUM)
+#undef LOG_ENUM
+    LOG_COUNT
+};
+
+// FNV-1a over each entry's "id\0format", last entry first (the nesting
+// below); tools/log_decode.py computes the same value
+constexpr uint32_t logFnv(const char *s, uint8_t n, uint32_t h)
+{
+    return n ? logFnv(s + 1, (uint8_t)(n - 1), (h ^ (uint8_t)*s) * 16777619UL) : h;
+}
+#define LOG_HASH_OPEN(id, fmt) logFnv(#id "\0" fmt, (uint8_t)(sizeof(#id "\0" fmt) - 1),
+#define LOG_HASH_CLOSE(id, fmt) )
+#define LOG_CATALOG_HASH (LOG_CATALOG(LOG_HASH_OPEN) 2166136261UL LOG_CATALOG(LOG_HASH_CLOSE))
+
+struct LogRecord
+{
+    uint8_t n;
+    uint8_t b[LOG_RECORD_MAX];
+};
+
+inline void logPut(LogRecord &r, const void *p, uint8_t len)
+{
+    if (r.n + len > LOG_RECORD_MAX)
+        len = (uint8_t)(LOG_RECORD_MAX - r.n);
+    memcpy(r.b + r.n, p, len); // AVR is little-endian: the wire order as is
+    r.n += len;
+}
+
+// One overload per catalog specifier; anything else fails to compile
+inline void logArg(LogRecord &r, char v) { logPut(r, &v, 1); }
+inline void logArg(LogRecord &r, int16_t v) { logPut(r, &v, 2); }
+inline void logArg(LogRecord &r, uint16_t v) { logPut(r, &v, 2); }
+inline void logArg(LogRecord &r, int32_t v) { logPut(r, &v, 4); }
+inline void logArg(LogRecord &r, uint32_t v) { logPut(r, &v, 4); }
+void logArg(LogRecord &r, const char *s);
+
+void dbgLogCommit(const LogRecord &r); // copy into the ring, or count a drop
+
+template <typename... Args>
+inline void dbgLog(LogId id, Args... args)
+{
+    LogRecord r;
+    r.n = 2;
+    r.b[0] = LOG_SYNC;
+    r.b[1] = id;
+    int expand[] = {0, (logArg(r, args), 0)...};
+    (void)expand;
+    dbgLogCommit(r);
+}
+
+void dbgLogDrain();  // non-blocking: move queued bytes into free USART TX space
+void dbgLogSettle(); // before a sleep that stops clkIO: drain all and let the last byte leave
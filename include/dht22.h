@@ -0,0 +1,14 @@
+#pragma once
+#include <Arduino.h>
+
+// Minimal DHT22 / AM2302 single-wire reader replacing the Adafruit library.
+// The sensor already sends humidity and temperature as integer tenths, so
+// the frame is handed on as-is: no float conversion anywhere.
+// Pulse widths are counted in polling-loop iterations at F_CPU (caller runs
+// the core undivided, see cpu_clock.h); interrupts are off for the ~5 ms
+// frame.
+
+#define DHT22_NO_READING INT16_MIN // sentinel for a failed / missing value
+
+void dht22Begin(); // sensor powered: release the data line (pull-up)
+bool dht22Read(int16_t *tenthsC, int16_t *tenthsRh); // one frame; false on timeout / checksum error
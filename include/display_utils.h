@@ -1,3 +1,6 @@
 #pragma once
+#include <Arduino.h>
 // LCD small helpers
-void lcdPrint16(const char *s);
+// Pad/truncate to 16 chars and write row through the shadow framebuffer
+// (only changed characters reach the controller).
+void lcdPrint16(uint8_t row, const char *s);
@@ -0,0 +1,24 @@
+#pragma once
+#include <Arduino.h>
+
+// Thin DS3231 driver with a shadow of the alarm (0x07-0x0D) and control
+// (0x0E) registers. Reprogramming diffs against the shadow and writes only
+// the changed span, coalesced with the status-flag clear into one burst
+// when that is cheaper than two. Time and status come back in a single
+// burst (0x0F wraps through 0x12 to 0x00-0x06). RTClib is only used for
+// begin()/lostPower().
+
+#define DS3231_STATUS_A1F 0x01
+#define DS3231_STATUS_A2F 0x02
+#define DS3231_STATUS_OSF 0x80
+
+bool ds3231Begin();                         // after rtc.begin(): 400 kHz bus + load shadow
+bool ds3231ReadTimeStatus(uint32_t *epoch); // one burst; refreshes the status shadow
+uint8_t ds3231Status();                     // status register as of the last burst
+bool ds3231SetTime(uint32_t epoch);         // time registers + clear OSF
+bool ds3231SetSqw1Hz();                     // 1 Hz on SQW, alarm interrupts off, alarm flags cleared
+bool ds3231SetAlarms(uint32_t a1Epoch, uint32_t a2Epoch); // INT mode, Alarm1 on date/h/m/s, Alarm2 on
+                                                          // date/h/m (0 = off), alarm flags cleared
+bool ds3231SetMinuteAlarm();                // INT mode, Alarm2 every minute at :00, Alarm1 off, flags cleared
+bool ds3231ClearAlarmFlags();               // release INT: clear A1F/A2F (status write only)
+uint32_t ds3231BusBytes();                  // address + register + data bytes moved since boot
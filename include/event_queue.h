@@ -0,0 +1,29 @@
+#pragma once
+#include <Arduino.h>
+
+// Single-producer / single-consumer ring of wake events.
+// Producers are the PCINT ISRs (AVR ISRs do not nest, so they act as one
+// producer); the consumer is loop(), which drains every queued event after
+// each wake. Each index is written by one side only and is a single byte,
+// so neither side needs to disable interrupts.
+
+#define EVENT_QUEUE_LEN 16 // power of two
+
+enum EventEdge : uint8_t
+{
+    EDGE_FALL = 0,
+    EDGE_RISE = 1
+};
+
+struct WakeEvent
+{
+    uint8_t pin;    // Arduino pin number (pins.h)
+    uint8_t edge;   // EventEdge
+    uint16_t stamp; // Timer0 time in 4 us units (micros() >> 2); wraps every 262 ms
+};
+
+void eventQueuePush(uint8_t pin, uint8_t edge); // ISR context only
+bool eventQueuePop(WakeEvent *out);             // loop only; tracks latency
+bool eventQueuePending();                       // at least one event queued
+uint8_t eventQueueDropped();                    // events lost to a full ring (saturates)
+uint16_t eventQueueMaxLatencyUs();              // worst ISR-to-loop latency seen
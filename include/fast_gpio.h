@@ -0,0 +1,63 @@
+#pragma once
+#include <Arduino.h>
+#include "pins.h"
+
+// Compile-time pin abstraction for ATmega328P Arduino pin numbers.
+// Port, bit and PCINT group resolve at compile time, so each access is a
+// single sbi/cbi/sbis instead of digitalWrite/digitalRead table lookups.
+//   D0-D7   : PORTD, PCINT16-23 (PCMSK2)
+//   D8-D13  : PORTB, PCINT0-5   (PCMSK0)
+//   A0-A5   : PORTC, PCINT8-13  (PCMSK1)
+template <uint8_t P>
+struct FastPin
+{
+    static_assert(P < 20, "FastPin: not an ATmega328P Arduino pin");
+
+    static constexpr uint8_t bit() { return (P < 8) ? P : (P < 14) ? (P - 8) : (P - 14); }
+    static constexpr uint8_t mask() { return (uint8_t)(1u << bit()); }
+    // Data-space addresses of PINx / DDRx / PORTx
+    static constexpr uint8_t pinAddr() { return (P < 8) ? 0x29 : (P < 14) ? 0x23 : 0x26; }
+    static constexpr uint8_t ddrAddr() { return pinAddr() + 1; }
+    static constexpr uint8_t portAddr() { return pinAddr() + 2; }
+    // Pin-change interrupt group (PCIEn / PCMSKn) and bit within PCMSKn
+    static constexpr uint8_t pcintGroup() { return (P < 8) ? 2 : (P < 14) ? 0 : 1; }
+    static constexpr uint8_t pcintMask() { return mask(); }
+
+    static inline void high() { _SFR_MEM8(portAddr()) |= mask(); }
+    static inline void low() { _SFR_MEM8(portAddr()) &= (uint8_t)~mask(); }
+    static inline void write(bool on)
+    {
+        if (on)
+            high();
+        else
+            low();
+    }
+    static inline bool read() { return (_SFR_MEM8(pinAddr()) & mask()) != 0; }
+    static inline void output() { _SFR_MEM8(ddrAddr()) |= mask(); }
+    static inline void input()
+    {
+        _SFR_MEM8(ddrAddr()) &= (uint8_t)~mask();
+        low(); // no pull-up
+    }
+    static inline void inputPullup()
+    {
+        _SFR_MEM8(ddrAddr()) &= (uint8_t)~mask();
+        high();
+    }
+};
+
+// Every pin in pins.h
+typedef FastPin<LCD_RS> PinLcdRs;
+typedef FastPin<LCD_EN> PinLcdEn;
+typedef FastPin<LCD_D4> PinLcdD4;
+typedef FastPin<LCD_D5> PinLcdD5;
+typedef FastPin<LCD_D6> PinLcdD6;
+typedef FastPin<LCD_D7> PinLcdD7;
+typedef FastPin<DHTPIN> PinDhtData;
+typedef FastPin<DHT_PWR> PinDhtPwr;
+typedef FastPin<VBAT_PIN> PinVbat;
+typedef FastPin<MODE_PIN> PinModeSwitch;
+typedef FastPin<SQW_PIN> PinSqw;
+typedef FastPin<BACKLIGHT_PIN> PinBacklight;
+typedef FastPin<BL_BUTTON_PIN> PinBlButton;
+typedef FastPin<SERIAL_RX_PIN> PinSerialRx;
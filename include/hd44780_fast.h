@@ -0,0 +1,30 @@
+#pragma once
+#include <Arduino.h>
+#include "pins.h"
+
+// HD44780 4-bit driver with the pins.h mapping resolved at compile time.
+// Nibbles are written through FastPin (single sbi/cbi per pin) and datasheet
+// minimum timing instead of LiquidCrystal's digitalWrite + 100 us per
+// nibble. Drop-in for the subset of LiquidCrystal the firmware uses.
+
+#ifndef LCD_EXEC_US
+#define LCD_EXEC_US 40 // command/data execution: 37 us @ 270 kHz + margin (raise for slow clones)
+#endif
+#define LCD_CLEAR_US 1600 // clear / return home: 1.52 ms
+
+class Hd44780Fast : public Print
+{
+public:
+    void begin(uint8_t cols, uint8_t rows);
+    void clear();
+    void setCursor(uint8_t col, uint8_t row);
+    void display();
+    void noDisplay();
+    size_t write(uint8_t value) override;
+    using Print::write;
+
+private:
+    void command(uint8_t value);
+    void send(uint8_t value, bool rs);
+    void writeNibble(uint8_t nibble);
+};
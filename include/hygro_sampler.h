@@ -0,0 +1,24 @@
+#pragma once
+#include <Arduino.h>
+#include "config.h"
+#include "pins.h"
+#include "dht22.h"
+
+// DHT22 acquisition as a resumable state machine.
+// Powering the sensor, waiting out its settle window and the retry gap are
+// separate steps, so the caller can sleep or do other work in between
+// instead of blocking in delay().
+
+void hygroSamplerPowerUp();           // DHT_PWR high, start settle window
+void hygroSamplerStart();             // begin a sample: power up, or reuse a pre-warmed / kept-powered sensor
+void hygroSamplerPowerDown();         // DHT_PWR low, release data pin
+bool hygroSamplerIsPowered();
+uint16_t hygroSamplerWaitMs();        // ms still to wait before the next read attempt (0 = ready, deadlineNow based)
+bool hygroSamplerStep();              // attempt a read if ready; true once finished (valid or failed)
+uint16_t hygroSamplerRun();           // sleep through remaining waits until finished; returns ms slept (already credited to deadlineNow)
+
+uint32_t hygroSamplerPoweredMs(); // cumulative DHT_PWR-high time (deadlineNow ms, wraps)
+uint16_t hygroSamplerPowerUps();  // cold starts, each paying a settle window (wraps)
+
+int16_t hygroSamplerTemperature(); // 0.1 degC, DHT22_NO_READING on failure
+int16_t hygroSamplerHumidity();    // 0.1 %RH, DHT22_NO_READING on failure
@@ -12,5 +12,5 @@ void interruptsEnableTick(bool en);
 void interruptsInitBacklightButton();
 // Temporarily mask/unmask the slide switch PCINT (D4) to suppress chatter.
 void interruptsMaskSwitch(bool mask);
-// Clear core wake flags (switch/tick/serial)
-inline void interruptsClearWakeFlags() { appClearWakeFlags(); }
+// Mask the serial RX PCINT (D0) while the USART is awake to receive itself.
+void interruptsMaskSerialRx(bool mask);
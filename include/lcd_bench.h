@@ -0,0 +1,9 @@
+#pragma once
+#include "config.h"
+
+#if ENABLE_LCD_BENCH
+// Boot-time microbenchmark: us per full-screen (2x16) refresh through
+// LiquidCrystal vs Hd44780Fast on the same pins. Prints over serial and
+// leaves the fast driver initialized with a blank screen.
+void lcdBenchRun();
+#endif
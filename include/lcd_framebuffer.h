@@ -0,0 +1,12 @@
+#pragma once
+#include <Arduino.h>
+
+#define LCD_COLS 16
+#define LCD_ROWS 2
+
+// 2x16 shadow of what is on the HD44780 glass. Rows are diffed against the
+// shadow and only the changed runs are sent (setCursor + chars); the cursor
+// is skipped when the controller's auto-increment already points there.
+
+void lcdFbReset();                                 // call after lcd.begin()/clear(): glass is blank
+void lcdFbWriteRow(uint8_t row, const char *text); // text: exactly LCD_COLS chars
@@ -0,0 +1,26 @@
+#pragma once
+#include <Arduino.h>
+
+// Fixed-width field writer for LCD lines, replacing snprintf (and
+// with it the vfprintf machinery). Writes stop one short of the buffer
+// size and the text is always terminated, matching snprintf truncation.
+//   LineWriter w(buf, sizeof(buf));
+//   w.num(h, 2, '0').ch(':').num(m, 2, '0');   // "%02u:%02u"
+//   w.fixed(-52, 1, 4);                         // "%4s" of "-5.2"
+
+class LineWriter
+{
+public:
+    LineWriter(char *buf, size_t n);
+    LineWriter &ch(char c);
+    LineWriter &str(const char *s);
+    LineWriter &num(uint32_t v, uint8_t width = 0, char fill = ' '); // right-aligned decimal
+    LineWriter &fixed(int32_t v, uint8_t decimals, uint8_t width = 0); // v / 10^decimals, right-aligned
+    uint8_t length() const { return (uint8_t)(p_ - buf_); }
+
+private:
+    LineWriter &digits(uint32_t a, bool neg, uint8_t decimals, uint8_t width, char fill);
+    char *buf_;
+    char *p_;
+    char *last_; // terminator slot
+};
@@ -0,0 +1,41 @@
+#pragma once
+
+// Debug message catalog: X(id, "format"). On the wire a message is just its
+// position in this list plus raw argument bytes; tools/log_decode.py reads
+// this file to turn captures back into text, so append new entries at the
+// end to keep old captures decodable. LOG_BOOT stays second and carries the
+// catalog hash (debug_log.h) that the decoder checks.
+// Specifiers and the C++ argument type each expects:
+//   %u uint16_t   %d int16_t   %lu uint32_t   %ld int32_t
+//   %c char       %s string (up to LOG_STR_MAX)   %t uint32_t epoch (decoded as UTC time)
+#define LOG_CATALOG(X)                                                 \
+    X(LOG_DROPPED, "[LOG] %u records dropped")                         \
+    X(LOG_BOOT, "[BOOT] catalog %lu")                                  \
+    X(LOG_WAKE_TICK, "[WAKE] SQW 1Hz")                                 \
+    X(LOG_WAKE_ALARM, "[WAKE] Alarm/INT")                              \
+    X(LOG_WAKE_SLIDE, "[WAKE] Slide")                                  \
+    X(LOG_WAKE_BUTTON, "[WAKE] Backlight btn")                         \
+    X(LOG_WAKE_SERIAL, "[WAKE] Serial RX")                             \
+    X(LOG_MODE_DEBOUNCED, "[MODE] Debounced switch change")            \
+    X(LOG_MODE_HYGRO, "[MODE] Enter Hygrometer")                       \
+    X(LOG_MODE_CLOCK, "[MODE] Enter Clock")                            \
+    X(LOG_RTC_SQW, "[RTC] SQW=1Hz (Clock mode)")                       \
+    X(LOG_RTC_MINUTE, "[RTC] Alarm2 every minute (Clock mode)")        \
+    X(LOG_HYGRO_PREWARM, "[HYGRO] Pre-warm DHT")                       \
+    X(LOG_HYGRO_SAMPLE, "[HYGRO] Sample")                              \
+    X(LOG_HYGRO_RETRY, "[HYGRO] Retry read")                           \
+    X(LOG_HYGRO_READING, "[HYGRO] T10=%d  RH10=%d  Vbat=%umV")         \
+    X(LOG_HYGRO_LCD_L2, "[HYGRO] LCD L2: %s")                          \
+    X(LOG_HYGRO_ELAPSED, "[HYGRO] Elapsed=%s(%c)  V=%umV  Flag=%c")    \
+    X(LOG_I2C_BYTES, "[I2C] bytes since last sample=%lu")              \
+    X(LOG_BAT, "[BAT] adc8=%u vcc=%u vA0=%u Vbat=%umV filt=%umV")      \
+    X(LOG_TIME_RESYNC, "[TIME] SQW resync %lu")                        \
+    X(LOG_PWR_PROFILE, "[PWR] Profile %s")                             \
+    X(LOG_ALRM_NEXT, "[ALRM] Next @ %t")                               \
+    X(LOG_ALRM_SANITY, "[ALRM] Sanity realign")                        \
+    X(LOG_FS_RESCHEDULE, "[FS] Silence > window -> reschedule")        \
+    X(LOG_ALRM_INTERVAL, "[ALRM] Interval %lu")                        \
+    X(LOG_BL_ON, "[BL] ON")                                            \
+    X(LOG_BL_OFF, "[BL] OFF")                                          \
+    X(LOG_RUNTIME, "[RT] days=%u model=%u trend=%u avg=%uuA")         \
+    X(LOG_ALRM_FAIL, "[ALRM] Write failed, WDT wake @ %t")
@@ -0,0 +1,26 @@
+#pragma once
+#include <Arduino.h>
+
+// Peripheral clock gating through the Power Reduction Register (PRR).
+// Every on-chip peripheral except Timer0 (millis) starts gated; a module
+// acquires the ones it needs around its work and releases them afterwards.
+// Reference counted, so nested users (setup holding TWI around several
+// DS3231 calls) keep the clock running until the last release.
+//
+// A module coming out of gating must be re-initialised (datasheet 9.10):
+// periphAcquire() returns true in that case. Main context only.
+
+enum Periph : uint8_t
+{
+    PERIPH_ADC = PRADC,
+    PERIPH_USART0 = PRUSART0,
+    PERIPH_SPI = PRSPI,
+    PERIPH_TIMER1 = PRTIM1,
+    PERIPH_TIMER2 = PRTIM2,
+    PERIPH_TWI = PRTWI,
+};
+
+void periphInit();              // gate all but Timer0; analog comparator and VBAT digital buffer off
+bool periphAcquire(Periph p);   // ungate; true when it was gated (caller re-initialises)
+void periphRelease(Periph p);   // gate again when the last user releases
+bool periphPowered(Periph p);   // clock currently running
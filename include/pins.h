@@ -16,4 +16,5 @@
 #define SQW_PIN 5  // DS3231 INT/SQW wired here
 #define BACKLIGHT_PIN 13
 #define BL_BUTTON_PIN 10
+#define SERIAL_RX_PIN 0 // USART RX, also a PCINT wake source
 #define DEGREE_CHAR 223
@@ -0,0 +1,30 @@
+#pragma once
+#include <Arduino.h>
+#include "config.h"
+
+// Battery-driven power profiles. The cached battery level (battery.*)
+// selects a profile with POWER_PROFILE_HYST_MV of hysteresis; modules ask
+// the profile for their limits instead of using the config.h constants.
+//   NORMAL     F / M: configured behaviour
+//   LOW        L: hygro interval >= PP_LOW_MIN_INTERVAL_SEC, short
+//              backlight, clock without seconds
+//   CRITICAL   !: hygro at UPDATE_INTERVAL_MAX_SEC, minimal refresh
+//   HIBERNATE  near cutoff: LCD off, no DHT reads, battery checks only
+// Each transition is announced on LCD line 1 until the next redraw.
+
+enum PowerProfile : uint8_t
+{
+    PP_NORMAL = 0,
+    PP_LOW,
+    PP_CRITICAL,
+    PP_HIBERNATE
+};
+
+void powerProfileUpdate(); // after a battery refresh / redraw: re-evaluate, announce changes
+PowerProfile powerProfile();
+
+uint32_t powerProfileBacklightSec();   // backlight auto-off duration
+uint32_t powerProfileMinIntervalSec(); // floor for the hygro sample interval (0 = none)
+bool powerProfileClockSeconds();       // clock may show seconds (1 Hz wakes) at all
+bool powerProfileHibernating();        // LCD off, sampling suspended
+bool powerProfileHibernateStep();      // mode updates: turns the LCD off once; true = skip the redraw
@@ -0,0 +1,22 @@
+#pragma once
+#include <Arduino.h>
+#include "config.h"
+
+// SRAM budget (ENABLE_RAM_MONITOR).
+// The gap between the static data (plus any heap) and the stack is painted
+// with RAM_PAINT at boot. Bytes the stack never reaches keep the pattern,
+// so the length of the painted run above the heap is the lowest free RAM
+// seen since boot (a stack byte that happens to equal the pattern can
+// overstate it by a byte or two). Static usage per module is reported at
+// build time by tools/ram_report.py.
+
+#if ENABLE_RAM_MONITOR
+
+#define RAM_PAINT 0xC5
+
+uint16_t ramStaticBytes(); // .data + .bss
+uint16_t ramFreeNow();     // between heap top and SP
+uint16_t ramFreeMin();     // never-touched bytes above the heap top (scans, ~100 us)
+void ramDump(Print &out);  // RM serial command
+
+#endif
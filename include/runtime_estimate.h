@@ -0,0 +1,21 @@
+#pragma once
+#include <Arduino.h>
+#include "config.h"
+
+// Remaining battery runtime, in days, at the current mode and interval.
+// Two estimates are blended:
+//   model  remaining capacity (Li-ion charge curve from the filtered
+//          battery voltage) over the average current of a per-state model
+//          (sleep / awake / DHT / backlight, EST_I_* in config.h) driven by
+//          the measured duty cycle
+//   trend  least-squares slope of the voltage history extrapolated to
+//          VBAT_HIBERNATE_MV; it weighs in once EST_TREND_MIN_POINTS are
+//          collected and reaches half weight with a full ring
+// Fed from each battery refresh; shown on the lit clock and by RT.
+
+#define RUNTIME_UNKNOWN 0xFFFF // no completed duty-cycle window yet
+#define RUNTIME_MAX_DAYS 9999
+
+void runtimeEstimateUpdate(uint16_t mv); // after a battery refresh: close the duty-cycle window, recompute
+uint16_t runtimeEstimateDays();          // blended estimate or RUNTIME_UNKNOWN
+void runtimeEstimateDump(Print &out);    // RT serial command
@@ -0,0 +1,33 @@
+#pragma once
+#include <Arduino.h>
+
+// USART0 driver replacing HardwareSerial so the RX interrupt is ours.
+// Transmit: interrupt-driven ring, same Print interface as Serial.
+// Receive: ISR(USART_RX_vect) assembles command lines in place (leading /
+// trailing spaces trimmed, command token upper-cased) and publishes each
+// completed line, so the main loop wakes once per command, not per byte.
+// The USART is clock-gated (periph_power) unless someone holds it: begin()
+// takes one hold; output while gated is dropped.
+
+#define SERIAL_TX_BUF 64   // power of two
+#define SERIAL_LINE_MAX 64 // bytes per line incl. terminator
+#define SERIAL_LINE_SLOTS 2 // completed lines held while the loop catches up
+
+class SerialPort : public Print
+{
+public:
+    void begin(unsigned long baud); // configure and take a hold
+    size_t write(uint8_t value) override;
+    void flush(); // wait until the last byte has left the shift register
+    int availableForWrite() override; // free TX ring slots (write() will not block)
+    using Print::write;
+};
+
+extern SerialPort uart; // defined in serial_port.cpp
+
+void serialPortHold(bool hold); // reference-counted USART clock (re-initialised on ungating)
+
+bool serialLineReady();        // a completed line is waiting
+const char *serialLinePeek();  // oldest completed line (valid until released)
+void serialLineRelease();      // done with the oldest line
+uint16_t serialLinesDropped(); // lines lost to overflow (too long / no free slot)
@@ -0,0 +1,27 @@
+#pragma once
+#include <Arduino.h>
+
+// Short power-down sleeps composed from WDT slices (15 ms .. 8 s).
+// millis() does not advance while powered down; the return value is the
+// time credited as slept so callers can keep their own bookkeeping.
+// A slice ended by any interrupt other than the WDT was cut short and is
+// not credited (it is repeated instead), so the result never
+// over-reports.
+uint16_t sleepPowerDownMs(uint16_t ms);
+
+// One power-down WDT slice: the longest that does not overshoot maxMs
+// (at least the 15 ms minimum).
+// Returns when the slice ends or any interrupt wakes the CPU; the result
+// is the slice length, or 0 if it was cut short.
+uint16_t sleepPowerDownSliceMs(uint32_t maxMs);
+
+// Power down with the WDT off until a wake event is queued (event_queue).
+// The queue check and the sleep instruction are atomic, so an edge
+// arriving just before sleeping cannot be lost.
+void sleepPowerDownUntilWake();
+
+// Idle sleep for the serial keep-awake window: CPU clock stopped, only
+// USART0 and Timer0 running (millis() keeps counting; the RX ISR assembles
+// bytes without waking us). Returns once a complete command line is
+// waiting, a wake event is queued, or ms have passed.
+void sleepIdleUntilLine(uint16_t ms);
@@ -1,6 +1,22 @@
 #pragma once
 #include <Arduino.h>
+#include "config.h"
 
-// Handle incoming serial RTC/time-setting commands.
+// Handle completed serial RTC/time-setting command lines (see serial_port).
 // Safe to call in any mode; commands only act if RTC present.
 void timeCommandsHandle();
+
+// Command summary for the help and boot banner; optional diagnostics are
+// listed under the same guards as their handlers
+#if ENABLE_CYCLE_PROFILER
+#define TIME_COMMANDS_HELP_PF " | PF[=0]"
+#else
+#define TIME_COMMANDS_HELP_PF ""
+#endif
+#if ENABLE_RAM_MONITOR
+#define TIME_COMMANDS_HELP_RM " | RM"
+#else
+#define TIME_COMMANDS_HELP_RM ""
+#endif
+#define TIME_COMMANDS_HELP \
+    "RD | CT[=±offset] | T=YYYY-MM-DD HH:MM:SS | U=<unix_epoch> | ST[=0] | RT" TIME_COMMANDS_HELP_PF TIME_COMMANDS_HELP_RM
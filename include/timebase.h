@@ -0,0 +1,16 @@
+#pragma once
+#include <Arduino.h>
+
+// Local epoch service (RTC present).
+// Clock mode: DS3231 1 Hz SQW rising edges advance a local epoch from
+// ISR(PCINT2_vect), so reading the time costs no I2C. The count is
+// seeded from the DS3231 right after an edge and re-seeded every
+// TIMEBASE_RESYNC_SEC or after the time is set.
+// Otherwise (alarm-driven hygro mode) the DS3231 is read at most once per
+// wake and extrapolated with the awake clock (cpuClockMillis) meanwhile.
+
+void timebaseSqwCounting(bool on); // SQW 1 Hz drives the epoch (clock mode)
+void timebaseOnSqwTick();          // call right after a tick wake: performs a pending resync in phase
+void timebaseInvalidate();         // call before sleeping: next read refreshes from the DS3231
+void timebaseResync();             // time was changed (T= / U= / CT): drop local state
+uint32_t timebaseNow();            // current unix epoch
@@ -4,25 +4,33 @@
 #include "config.h"
 #include "pins.h"
 #include "battery.h"
+#include "dht22.h"
 
 // Build 16-char (or shorter) lines; caller pads via lcdPrint16.
 // Clock mode: if haveRTC true, use DateTime; else softSeconds for fallback.
+// showSeconds false renders HH:MM only (minute clock profile).
 void buildClockLines(bool haveRTC,
                      const DateTime &now,
                      unsigned long softSeconds,
-                     float vbat,
+                     uint16_t vbatMv,
                      char *line1, size_t l1n,
-                     char *line2, size_t l2n);
+                     char *line2, size_t l2n,
+                     bool showSeconds = true);
 
-// Hygrometer line 1: temperature + humidity or error.
-void buildHygroLine1(float tc, float rh, char *line1, size_t n);
+// Hygrometer line 1: temperature + humidity (0.1 units) or error.
+void buildHygroLine1(int16_t tc10, int16_t rh10, char *line1, size_t n);
 
 // Hygrometer line 2 built from elapsed string (already computed),
-// rtcFlag ('R' or 'T'), battery voltage + flag.
+// rtcFlag ('R' or 'T'), battery millivolts + flag.
 void buildHygroLine2(const char *elapsed, char rtcFlag,
-                     float vbat, char batFlag,
+                     uint16_t vbatMv, char batFlag,
                      char *line2, size_t n);
 
+// Clock line 2 while lit: date (or "No RTC") + remaining runtime in days
+// (RUNTIME_UNKNOWN shows "--") + battery flag, in place of the voltage.
+void buildRuntimeLine2(bool haveRTC, const DateTime &now, uint16_t days,
+                       char batFlag, char *line2, size_t n);
+
 // Elapsed time helpers (minutes granularity: dHH:MM). These were in main.cpp.
 void formatElapsed(const TimeSpan &ts, char *out, size_t n);     // RTC-based (TimeSpan)
 void formatElapsedMillis(unsigned long ms, char *out, size_t n); // Millis-based fallback
@@ -0,0 +1,42 @@
+#pragma once
+#include <Arduino.h>
+
+// Wake and awake-time profiler (ENABLE_WAKE_STATS).
+// Every main-loop wake is counted against each source that caused it, and
+// the awake time until the next wake goes to the first source in the fixed
+// order drainWakeEvents() claims them (tick, alarm, slide, button, serial),
+// not to the one that arrived first. Failsafe work takes over the rest of
+// a wake. Named phases accumulate the awake time spent inside them. Time
+// is cpuClockMicros(): Timer0 stops in power-down, so only awake and idle
+// time accrues. Counts are 32-bit and times are kept in ms (with a us
+// remainder) so days of logging do not wrap. Counters live in RAM; the ST
+// serial command dumps (ST) or clears (ST=0) them.
+
+enum WakeSource : uint8_t
+{
+    WS_TIMER = 0, // deadline / WDT slice, no pin event
+    WS_TICK,      // DS3231 1 Hz SQW
+    WS_ALARM,     // DS3231 alarm INT
+    WS_SLIDE,     // mode switch
+    WS_BUTTON,    // backlight button
+    WS_SERIAL,    // serial RX
+    WS_FAILSAFE,  // alarm failsafe forced a sample
+    WS_COUNT
+};
+
+enum WakePhase : uint8_t
+{
+    WP_DHT = 0, // DHT22 frame read
+    WP_ADC,     // battery conversions
+    WP_LCD,     // LCD bus writes
+    WP_I2C,     // DS3231 transactions
+    WP_SERIAL,  // serial window: command handling + idle wait
+    WP_COUNT
+};
+
+void wakeStatsWake();               // main loop is back from its sleep
+void wakeStatsSource(WakeSource s); // a cause of the current wake
+uint32_t wakeStatsPhaseBegin();     // stamp for wakeStatsPhaseEnd
+void wakeStatsPhaseEnd(WakePhase p, uint32_t stamp, uint32_t missedUs = 0); // missedUs: time Timer0 was halted
+void wakeStatsReset();
+void wakeStatsDump(Print &out);
@@ -1,5 +1,9 @@
 #include "alarm_scheduler.h"
 #include <RTClib.h>
+#include "cycle_profiler.h"
+#include "ds3231.h"
+#include "deadline.h"
+#include "power_profile.h"
 
 extern RTC_DS3231 rtc; // from main
 #include "app_state.h"
@@ -8,34 +12,123 @@ extern AppState g_app; // global state
 #if ENABLE_ALARM_FAILSAFE
 static uint32_t g_lastFireEpoch = 0; // last serviced alarm/sample epoch
 #endif
-static uint32_t g_nextEpoch = 0;   // next target on UPDATE_INTERVAL_SEC grid
+static uint32_t g_nextEpoch = 0;   // next target on the current interval's grid
 static uint32_t g_elapsedBase = 0; // first on-grid epoch after entering mode
 
+// Adaptive interval: UPDATE_INTERVAL_SEC << g_shift
+static uint8_t g_shift = 0;
+static uint8_t g_stableCount = 0;
+static int16_t g_lastTc = DHT22_NO_READING, g_lastRh = DHT22_NO_READING; // 0.1 units
+
+static uint8_t maxShift()
+{
+    uint8_t k = 0;
+#if ADAPT_INTERVAL
+    while (((uint32_t)UPDATE_INTERVAL_SEC << (k + 1)) <= UPDATE_INTERVAL_MAX_SEC)
+        k++;
+#endif
+    return k;
+}
+
+// First grid point strictly after nowEpoch
+static uint32_t nextGrid(uint32_t nowEpoch)
+{
+    uint32_t interval = hygroSchedulerIntervalSec();
+    return nowEpoch - (nowEpoch % interval) + interval;
+}
+
+// No RTC: arm DL_SAMPLE at the first point strictly after now on the
+// modeStartMs grid of the current interval
+static void armGridDeadline()
+{
+    uint32_t period = hygroSchedulerIntervalSec() * 1000UL;
+    uint32_t since = deadlineNow() - g_app.modeStartMs;
+    deadlineSetAt(DL_SAMPLE, g_app.modeStartMs + (since / period + 1) * period);
+}
+
+// Failsafe / sanity windows stretch with the interval
+static uint32_t slackSec() { return hygroSchedulerIntervalSec() - UPDATE_INTERVAL_SEC; }
+
+// What Alarm1 is currently programmed for
+enum AlarmStage : uint8_t
+{
+    STAGE_PREWARM = 0, // grid - DHT_PREWARM_SEC: power the sensor
+    STAGE_SAMPLE = 1   // grid second: read
+};
+static AlarmStage g_stage = STAGE_SAMPLE;
+
 static void programAlarm(uint32_t epoch)
+{
+    PROF_SCOPE(PR_PROGRAM_ALARM);
+    if (!g_app.rtcAvailable)
+        return;
+#if ENABLE_ALARM_FAILSAFE
+    // Alarm2 backstop: first whole minute past the failsafe window, so a
+    // missed Alarm1 still wakes us without polling the RTC while asleep.
+    uint32_t backstop = ((epoch + ALARM_FAILSAFE_SEC + 1 + 59) / 60) * 60;
+#else
+    uint32_t backstop = 0;
+#endif
+    if (ds3231SetAlarms(epoch, backstop)) // INT mode + alarm regs + flag clear, one burst
+    {
+        deadlineCancel(DL_ALARM_RETRY);
+        DBG_LOG(LOG_ALRM_NEXT, epoch);
+        return;
+    }
+    // Nothing armed on the DS3231 would wake us: sleep in WDT slices until
+    // the target instead, then retry the write (hygroSchedulerSanity)
+    uint32_t now = timebaseNow();
+    deadlineSet(DL_ALARM_RETRY, (epoch > now) ? (epoch - now) * 1000UL : 1000UL);
+    DBG_LOG(LOG_ALRM_FAIL, epoch);
+}
+
+// Program Alarm1 for the pre-warm second of g_nextEpoch, or for the grid
+// second itself when the sensor stays powered or the pre-warm slot has passed.
+static void programNext(uint32_t nowEpoch)
+{
+    uint32_t warmAt = g_nextEpoch - DHT_PREWARM_SEC;
+    if (!hygroSchedulerKeepSensorPowered() && !powerProfileHibernating() && warmAt > nowEpoch)
+    {
+        g_stage = STAGE_PREWARM;
+        programAlarm(warmAt);
+    }
+    else
+    {
+        g_stage = STAGE_SAMPLE;
+        programAlarm(g_nextEpoch);
+    }
+}
+
+// Interval changed: move the pending sample onto the new grid. The base
+// grid is a superset of every interval's, so the elapsed anchor stays.
+static void regrid()
 {
     if (!g_app.rtcAvailable)
+    {
+        armGridDeadline();
         return;
-    rtc.writeSqwPinMode(DS3231_OFF); // INT mode
-    rtc.clearAlarm(1);
-    rtc.clearAlarm(2);
-    DateTime dt((uint32_t)epoch);
-    rtc.setAlarm1(dt, DS3231_A1_Date);
-    DBG_PRINT(F("[ALRM] Next @ "));
-    DBG_PRINT(dt.timestamp(DateTime::TIMESTAMP_TIME));
-    DBG_PRINT(F(" ("));
-    DBG_PRINT(epoch);
-    DBG_PRINTLN(F(")"));
+    }
+    if (g_nextEpoch == 0)
+        return;
+    uint32_t nowEpoch = timebaseNow();
+    g_nextEpoch = nextGrid(nowEpoch);
+    programNext(nowEpoch);
 }
 
 void hygroSchedulerInit(uint32_t startEpoch)
 {
+    g_shift = 0;
+    g_stableCount = 0;
+    g_lastTc = g_lastRh = DHT22_NO_READING;
     if (!g_app.rtcAvailable)
+    {
+        // No RTC: the grid is a deadline on the monotonic clock instead of an alarm
+        armGridDeadline();
         return;
-    g_nextEpoch = startEpoch - (startEpoch % UPDATE_INTERVAL_SEC) + UPDATE_INTERVAL_SEC;
-    if (g_nextEpoch <= startEpoch)
-        g_nextEpoch += UPDATE_INTERVAL_SEC;
+    }
+    g_nextEpoch = nextGrid(startEpoch);
     g_elapsedBase = g_nextEpoch; // anchor
-    programAlarm(g_nextEpoch);
+    programNext(startEpoch);
 #if ENABLE_ALARM_FAILSAFE
     g_lastFireEpoch = startEpoch; // treat as just fired now
 #endif
@@ -44,30 +137,44 @@ void hygroSchedulerInit(uint32_t startEpoch)
 bool hygroSchedulerShouldFire(uint32_t nowEpoch)
 {
     if (!g_app.rtcAvailable)
-        return false;
+        return deadlineReached(DL_SAMPLE);
     if (g_nextEpoch == 0)
         return false;
-    return rtc.alarmFired(1) || (nowEpoch >= g_nextEpoch);
+    if (g_stage != STAGE_SAMPLE)
+        return nowEpoch >= g_nextEpoch; // pre-warm missed: catch up, sampler settles inline
+    return (ds3231Status() & DS3231_STATUS_A1F) || (nowEpoch >= g_nextEpoch);
 }
 
-void hygroSchedulerAdvanceAfterFire(uint32_t nowEpoch)
+bool hygroSchedulerPrewarmDue(uint32_t nowEpoch)
+{
+    if (!g_app.rtcAvailable)
+        return false;
+    if (g_nextEpoch == 0 || g_stage != STAGE_PREWARM)
+        return false;
+    return (ds3231Status() & DS3231_STATUS_A1F) || (nowEpoch >= g_nextEpoch - DHT_PREWARM_SEC);
+}
+
+void hygroSchedulerArmSample()
 {
     if (!g_app.rtcAvailable)
         return;
-    if (g_nextEpoch == 0)
+    g_stage = STAGE_SAMPLE;
+    programAlarm(g_nextEpoch);
+}
+
+void hygroSchedulerAdvanceAfterFire(uint32_t nowEpoch)
+{
+    if (!g_app.rtcAvailable)
+    {
+        deadlineAdvance(DL_SAMPLE, hygroSchedulerIntervalSec() * 1000UL);
         return;
-    rtc.clearAlarm(1);
-    // ensure next strictly in future on grid
+    }
     if (g_nextEpoch == 0)
         return;
+    // next strictly in future on the current interval's grid (reprogramming clears A1F)
     if (g_nextEpoch <= nowEpoch)
-    {
-        do
-        {
-            g_nextEpoch += UPDATE_INTERVAL_SEC;
-        } while (g_nextEpoch <= nowEpoch);
-    }
-    programAlarm(g_nextEpoch);
+        g_nextEpoch = nextGrid(nowEpoch);
+    programNext(nowEpoch);
 }
 
 void hygroSchedulerMarkSample(uint32_t nowEpoch)
@@ -83,18 +190,18 @@ void hygroSchedulerSanity(uint32_t nowEpoch)
         return;
     if (g_nextEpoch == 0)
         return;
+    if (deadlineTake(DL_ALARM_RETRY))
+        programNext(nowEpoch); // an alarm write failed: try again
     if (g_nextEpoch < nowEpoch)
         return; // let main treat as fired first
     uint32_t ahead = g_nextEpoch - nowEpoch;
-    if (ahead > ALARM_MAX_AHEAD_SEC)
+    if (ahead > ALARM_MAX_AHEAD_SEC + slackSec())
     {
-        DBG_PRINTLN(F("[ALRM] Sanity realign"));
+        DBG_LOG(LOG_ALRM_SANITY);
         // Realign to next grid from now
-        g_nextEpoch = nowEpoch - (nowEpoch % UPDATE_INTERVAL_SEC) + UPDATE_INTERVAL_SEC;
-        if (g_nextEpoch <= nowEpoch)
-            g_nextEpoch += UPDATE_INTERVAL_SEC;
+        g_nextEpoch = nextGrid(nowEpoch);
         g_elapsedBase = g_nextEpoch; // re-anchor after large jump
-        programAlarm(g_nextEpoch);
+        programNext(nowEpoch);
     }
 }
 
@@ -105,13 +212,12 @@ bool hygroSchedulerFailsafeCheck(uint32_t nowEpoch)
         return false;
     if (g_nextEpoch == 0)
         return false;
-    if ((uint32_t)(nowEpoch - g_lastFireEpoch) > ALARM_FAILSAFE_SEC)
+    bool backstop = ds3231Status() & DS3231_STATUS_A2F; // Alarm2 fired: Alarm1 was missed
+    if (backstop || (uint32_t)(nowEpoch - g_lastFireEpoch) > ALARM_FAILSAFE_SEC + slackSec())
     {
-        DBG_PRINTLN(F("[FS] Silence > window -> reschedule"));
-        g_nextEpoch = nowEpoch - (nowEpoch % UPDATE_INTERVAL_SEC) + UPDATE_INTERVAL_SEC;
-        if (g_nextEpoch <= nowEpoch)
-            g_nextEpoch += UPDATE_INTERVAL_SEC;
-        programAlarm(g_nextEpoch);
+        DBG_LOG(LOG_FS_RESCHEDULE);
+        g_nextEpoch = nextGrid(nowEpoch);
+        programNext(nowEpoch);
         g_lastFireEpoch = nowEpoch;
         return true;
     }
@@ -121,3 +227,62 @@ bool hygroSchedulerFailsafeCheck(uint32_t nowEpoch)
 
 uint32_t hygroSchedulerNextEpoch() { return g_nextEpoch; }
 uint32_t hygroSchedulerBaseEpoch() { return g_elapsedBase; }
+
+bool hygroSchedulerKeepSensorPowered()
+{
+    return hygroSchedulerIntervalSec() <= DHT_KEEP_POWERED_MAX_SEC;
+}
+
+uint32_t hygroSchedulerIntervalSec()
+{
+    uint32_t interval = (uint32_t)UPDATE_INTERVAL_SEC << g_shift;
+    uint32_t floorSec = powerProfileMinIntervalSec(); // low battery: stretch, staying on the grid
+    while (interval < floorSec && (interval << 1) <= UPDATE_INTERVAL_MAX_SEC)
+        interval <<= 1;
+    return interval;
+}
+
+void hygroSchedulerNoteReading(int16_t tc10, int16_t rh10)
+{
+#if ADAPT_INTERVAL
+    uint8_t shift = g_shift;
+    bool valid = tc10 != DHT22_NO_READING && rh10 != DHT22_NO_READING;
+    bool havePrev = g_lastTc != DHT22_NO_READING;
+    bool stable = valid && havePrev &&
+                  abs(tc10 - g_lastTc) < ADAPT_DELTA_T_C10 && abs(rh10 - g_lastRh) < ADAPT_DELTA_RH10;
+    if (!stable)
+    {
+        g_stableCount = 0;
+        if (valid && havePrev)
+            shift = 0; // step change: back to the fast rate
+    }
+    else if (++g_stableCount >= ADAPT_STABLE_SAMPLES && shift < maxShift())
+    {
+        g_stableCount = 0;
+        shift++;
+    }
+    if (valid)
+    {
+        g_lastTc = tc10;
+        g_lastRh = rh10;
+    }
+    if (shift == g_shift)
+        return;
+    g_shift = shift;
+    DBG_LOG(LOG_ALRM_INTERVAL, hygroSchedulerIntervalSec());
+    regrid();
+#endif
+}
+
+void hygroSchedulerProfileChanged()
+{
+    if (g_app.currentMode != MODE_HYGRO)
+        return; // clock mode owns the alarms; enterMode re-inits the grid
+    DBG_LOG(LOG_ALRM_INTERVAL, hygroSchedulerIntervalSec());
+    regrid();
+#if ENABLE_ALARM_FAILSAFE
+    // The silence window may have shrunk under the last (longer) interval's gap
+    if (g_app.rtcAvailable)
+        g_lastFireEpoch = timebaseNow();
+#endif
+}
@@ -1,44 +1,50 @@
 #include "backlight.h"
-#include "app_state.h" // for inline currentSeconds()
+#include "deadline.h"
+#include "fast_gpio.h"
+#include "power_profile.h"
 
 static bool g_active = false;
-static uint32_t g_startSec = 0;
-
-// rtcAvailable no longer needed directly; using g_app if required in future
-// (kept currentSeconds extern for time base)
-// currentSeconds inline is available via app_state.h
+static uint32_t g_onAt = 0;  // deadlineNow() when lit
+static uint32_t g_litMs = 0; // completed lit periods
 
 void backlightInit()
 {
-    pinMode(BACKLIGHT_PIN, OUTPUT);
-    digitalWrite(BACKLIGHT_PIN, LOW);
+    PinBacklight::output();
+    PinBacklight::low();
     g_active = false;
-    g_startSec = 0;
+    deadlineCancel(DL_BACKLIGHT);
 }
 
 void backlightOn()
 {
-    digitalWrite(BACKLIGHT_PIN, HIGH);
+    if (powerProfileHibernating())
+        return; // LCD is off
+    PinBacklight::high();
+    if (!g_active)
+        g_onAt = deadlineNow();
     g_active = true;
-    g_startSec = currentSeconds();
-    DBG_PRINTLN(F("[BL] ON"));
+    deadlineSet(DL_BACKLIGHT, powerProfileBacklightSec() * 1000UL); // loop wakes for the auto-off
+    DBG_LOG(LOG_BL_ON);
 }
 
 void backlightOff()
 {
-    digitalWrite(BACKLIGHT_PIN, LOW);
+    PinBacklight::low();
     if (g_active)
-        DBG_PRINTLN(F("[BL] OFF"));
+    {
+        g_litMs += deadlineNow() - g_onAt;
+        DBG_LOG(LOG_BL_OFF);
+    }
     g_active = false;
+    deadlineCancel(DL_BACKLIGHT);
 }
 
-void backlightMaintain(uint32_t nowSeconds)
+void backlightMaintain()
 {
-    if (!g_active)
-        return;
-    if ((int32_t)(nowSeconds - g_startSec) >= (int32_t)BACKLIGHT_DURATION_SEC)
+    if (deadlineTake(DL_BACKLIGHT))
         backlightOff();
 }
 
 bool backlightIsActive() { return g_active; }
-uint32_t backlightStartSeconds() { return g_startSec; }
+
+uint32_t backlightOnMs() { return g_active ? g_litMs + (deadlineNow() - g_onAt) : g_litMs; }
@@ -0,0 +1,96 @@
+#include "battery.h"
+#include <avr/sleep.h>
+#include "cycle_profiler.h"
+#include "periph_power.h"
+#include "runtime_estimate.h"
+#include "wake_stats.h"
+
+static uint16_t g_mv = 0;           // filtered battery millivolts
+static uint32_t g_lastRefreshSec = 0;
+static bool g_valid = false;
+static uint8_t g_convs = 0;         // conversions slept through this refresh (Timer0 halted)
+
+EMPTY_INTERRUPT(ADC_vect); // only needed to wake from SLEEP_MODE_ADC
+
+// One conversion with the CPU halted. Entering ADC noise-reduction sleep
+// starts the conversion; if another interrupt (Timer0) wakes us first the
+// remainder (< 110 us at 125 kHz ADC clock) is finished by polling.
+static uint16_t adcConvertAsleep()
+{
+    set_sleep_mode(SLEEP_MODE_ADC);
+    ADCSRA |= _BV(ADIE);
+    g_convs++;
+    noInterrupts();
+    sleep_enable();
+    interrupts(); // sei + sleep execute back to back
+    sleep_cpu();
+    sleep_disable();
+    while (bit_is_set(ADCSRA, ADSC))
+        ;
+    ADCSRA &= ~_BV(ADIE);
+    return ADC;
+}
+
+static uint16_t readVccMillivolts()
+{
+    ADMUX = _BV(REFS0) | _BV(MUX3) | _BV(MUX2) | _BV(MUX1); // 1.1V bandgap vs AVcc
+    // Bandgap needs ~1 ms to settle after selection: discard conversions asleep
+    for (uint8_t i = 0; i < 10; i++)
+        (void)adcConvertAsleep();
+    uint16_t raw = adcConvertAsleep();
+    return (uint16_t)((1100UL * 1023UL) / raw);
+}
+
+void batteryRefresh()
+{
+    PROF_SCOPE(PR_BATTERY);
+    dbgLogSettle(); // ADC noise-reduction sleep stops the USART clock too
+    // ADC registers are not retained reliably across PRR gating: set them up in full
+    uint32_t t0 = wakeStatsPhaseBegin();
+    g_convs = 0;
+    periphAcquire(PERIPH_ADC);
+    ADCSRA = _BV(ADEN) | _BV(ADPS2) | _BV(ADPS1) | _BV(ADPS0); // 16 MHz / 128 = 125 kHz
+    ADMUX = _BV(REFS0) | ((VBAT_PIN - A0) & 0x07); // AVcc ref, VBAT channel
+    (void)adcConvertAsleep();                       // charge S/H cap from the high-impedance divider
+    uint16_t acc = 0;
+    const uint8_t N = 8;
+    for (uint8_t i = 0; i < N; i++)
+        acc += adcConvertAsleep();
+    uint16_t vccMv = readVccMillivolts();
+    ADCSRA = 0; // disable before gating
+    periphRelease(PERIPH_ADC);
+    // micros() stood still during each conversion: 13 ADC clocks of 8 us, 25 for the first
+    wakeStatsPhaseEnd(WP_ADC, t0, ((uint32_t)g_convs * 13 + 12) * 8);
+    // acc * vcc <= 8184 * 5500 and pinMv * scale <= 5500 * 101033: both fit 32 bits
+    uint32_t pinMv = ((uint32_t)acc * vccMv + (1023UL * N) / 2) / (1023UL * N);
+    uint16_t mv = (uint16_t)((pinMv * VBAT_SCALE_Q16 + 0x8000UL) >> 16);
+    if (!g_valid)
+        g_mv = mv;
+    else
+        g_mv = (uint16_t)((int32_t)g_mv + ((int32_t)mv - (int32_t)g_mv) / 4); // IIR, 1/4 weight
+    g_valid = true;
+    DBG_LOG(LOG_BAT, acc, vccMv, (uint16_t)pinMv, mv, g_mv);
+    runtimeEstimateUpdate(g_mv);
+}
+
+void batteryMaintain(uint32_t nowSeconds)
+{
+    if (!g_valid || (uint32_t)(nowSeconds - g_lastRefreshSec) >= BATTERY_REFRESH_SEC)
+    {
+        batteryRefresh();
+        g_lastRefreshSec = nowSeconds;
+    }
+}
+
+uint16_t batteryForDisplay(uint32_t nowSeconds)
+{
+#if BATTERY_REFRESH_ON_DISPLAY
+    batteryRefresh();
+    g_lastRefreshSec = nowSeconds;
+#else
+    batteryMaintain(nowSeconds);
+#endif
+    return batteryMillivolts();
+}
+
+uint16_t batteryMillivolts() { return g_mv; }
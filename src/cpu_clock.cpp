@@ -0,0 +1,64 @@
+#include "cpu_clock.h"
+#include <avr/power.h>
+#include "config.h"
+#include "periph_power.h"
+
+static uint8_t g_shift = CPU_FULL;
+static unsigned long g_markUs = 0; // micros() at the last divider change
+static uint32_t g_lostMs = 0;      // Timer0 time missed while divided
+static uint16_t g_lostUs = 0;      // sub-millisecond remainder
+
+// Each nominal micros() tick while divided by 2^s was 2^s real ones
+static uint32_t missedUs(unsigned long now)
+{
+    return (uint32_t)(now - g_markUs) * ((1UL << g_shift) - 1);
+}
+
+uint8_t cpuClockSet(uint8_t shift)
+{
+    uint8_t prev = g_shift;
+#if CPU_CLOCK_SCALING
+    if (shift != CPU_FULL && periphPowered(PERIPH_USART0))
+        shift = CPU_FULL; // baud rate is derived from the core clock
+    if (shift == prev)
+        return prev;
+    unsigned long now = micros();
+    if (prev != CPU_FULL)
+    {
+        uint32_t us = missedUs(now) + g_lostUs;
+        g_lostMs += us / 1000;
+        g_lostUs = (uint16_t)(us % 1000);
+    }
+    g_markUs = now;
+    clock_prescale_set((clock_div_t)shift); // timed CLKPR sequence, interrupts off inside
+    g_shift = shift;
+#else
+    (void)shift;
+#endif
+    return prev;
+}
+
+uint8_t cpuClockShift() { return g_shift; }
+
+uint32_t cpuClockMillis()
+{
+    uint32_t ms = millis() + g_lostMs;
+    if (g_shift != CPU_FULL)
+        ms += (missedUs(micros()) + g_lostUs) / 1000; // phase still in progress
+    return ms;
+}
+
+uint32_t cpuClockMicros()
+{
+    unsigned long now = micros();
+    uint32_t us = now + g_lostMs * 1000UL + g_lostUs;
+    if (g_shift != CPU_FULL)
+        us += missedUs(now);
+    return us;
+}
+
+void cpuClockDelayUs(uint16_t us)
+{
+    // delayMicroseconds() counts cycles for F_CPU; round up so waits never shorten
+    delayMicroseconds((uint16_t)((us + (1u << g_shift) - 1) >> g_shift));
+}
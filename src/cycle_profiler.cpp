@@ -0,0 +1,90 @@
+#include "cycle_profiler.h"
+
+#if ENABLE_CYCLE_PROFILER
+#include "periph_power.h"
+
+struct ProfStat
+{
+    uint16_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum; // profiling builds only: keeps the mean exact
+};
+
+static ProfStat g_stats[PR_COUNT];
+static volatile uint16_t g_ovf = 0; // Timer1 overflows: high half of profNow()
+static uint16_t g_overhead = 0;     // cycles one profNow() adds to a region
+
+static const char kNames[PR_COUNT][13] PROGMEM = {
+    "hygro_update", "clock_update", "battery", "lcd_print16", "hygro_line1",
+    "hygro_line2", "clock_lines", "alarm_prog", "rtc_read", "time_cmds"};
+
+ISR(TIMER1_OVF_vect) { g_ovf++; }
+
+uint32_t profNow()
+{
+    uint8_t sreg = SREG;
+    cli();
+    uint16_t lo = TCNT1;
+    uint16_t hi = g_ovf;
+    if ((TIFR1 & _BV(TOV1)) && lo < 0x8000)
+        hi++; // wrapped after cli, ISR still pending
+    SREG = sreg;
+    return ((uint32_t)hi << 16) | lo;
+}
+
+void profRecord(ProfRegion r, uint32_t start)
+{
+    uint32_t c = profNow() - start;
+    c = (c > g_overhead) ? c - g_overhead : 0;
+    ProfStat &s = g_stats[r];
+    if (s.count == 0xFFFF)
+        return; // saturated: keep the mean consistent
+    if (s.count == 0 || c < s.min)
+        s.min = c;
+    if (c > s.max)
+        s.max = c;
+    s.sum += c;
+    s.count++;
+}
+
+void profReset() { memset(g_stats, 0, sizeof(g_stats)); }
+
+void profInit()
+{
+    periphAcquire(PERIPH_TIMER1); // held for good: the profiler is a debug build
+    TCCR1A = 0;
+    TCCR1B = _BV(CS10); // normal mode, clk/1
+    TCNT1 = 0;
+    TIFR1 = _BV(TOV1);
+    TIMSK1 = _BV(TOIE1);
+    uint32_t t0 = profNow();
+    g_overhead = (uint16_t)(profNow() - t0);
+    profReset();
+}
+
+void profDump(Print &out)
+{
+    out.print(F("[PF] cycles, overhead="));
+    out.println(g_overhead);
+    for (uint8_t r = 0; r < PR_COUNT; r++)
+    {
+        const ProfStat &s = g_stats[r];
+        out.print(F("[PF] "));
+        out.print((const __FlashStringHelper *)kNames[r]);
+        out.print(F(" n="));
+        out.print(s.count);
+        if (s.count)
+        {
+            out.print(F(" min="));
+            out.print(s.min);
+            out.print(F(" max="));
+            out.print(s.max);
+            out.print(F(" mean="));
+            out.print((uint32_t)(s.sum / s.count));
+        }
+        out.println();
+    }
+}
+
+#endif
@@ -0,0 +1,72 @@
+#include "deadline.h"
+#include "cpu_clock.h"
+
+static uint32_t g_sleptMs = 0; // power-down time credited on top of the awake clock
+static uint32_t g_at[DL_COUNT];
+static uint8_t g_armed = 0; // bit per DeadlineId
+
+uint32_t deadlineNow() { return cpuClockMillis() + g_sleptMs; }
+
+void deadlineCreditSleep(uint32_t ms) { g_sleptMs += ms; }
+
+void deadlineSet(DeadlineId id, uint32_t inMs)
+{
+    deadlineSetAt(id, deadlineNow() + inMs);
+}
+
+void deadlineSetAt(DeadlineId id, uint32_t atMs)
+{
+    g_at[id] = atMs;
+    g_armed |= (uint8_t)(1u << id);
+}
+
+void deadlineAdvance(DeadlineId id, uint32_t periodMs)
+{
+    uint32_t now = deadlineNow();
+    uint32_t at = deadlineArmed(id) ? g_at[id] : now;
+    do
+    {
+        at += periodMs;
+    } while ((int32_t)(at - now) <= 0);
+    deadlineSetAt(id, at);
+}
+
+void deadlineCancel(DeadlineId id) { g_armed &= (uint8_t)~(1u << id); }
+
+bool deadlineArmed(DeadlineId id) { return g_armed & (1u << id); }
+
+bool deadlineReached(DeadlineId id)
+{
+    return deadlineArmed(id) && (int32_t)(deadlineNow() - g_at[id]) >= 0;
+}
+
+bool deadlineTake(DeadlineId id)
+{
+    if (!deadlineReached(id))
+        return false;
+    deadlineCancel(id);
+    return true;
+}
+
+bool deadlineActive(DeadlineId id)
+{
+    deadlineTake(id); // a closed window must not hold the loop awake
+    return deadlineArmed(id);
+}
+
+uint32_t deadlineMsToNext()
+{
+    uint32_t now = deadlineNow();
+    uint32_t best = DEADLINE_NONE;
+    for (uint8_t i = 0; i < DL_COUNT; ++i)
+    {
+        if (!(g_armed & (1u << i)))
+            continue;
+        int32_t d = (int32_t)(g_at[i] - now);
+        if (d <= 0)
+            return 0;
+        if ((uint32_t)d < best)
+            best = (uint32_t)d;
+    }
+    return best;
+}
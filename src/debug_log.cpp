@@ -0,0 +1,98 @@
+#include "debug_log.h"
+#include <avr/sleep.h>
+#include "serial_port.h"
+
+void logArg(LogRecord &r, const char *s)
+{
+    uint8_t len = (uint8_t)strnlen(s, LOG_STR_MAX);
+    logPut(r, &len, 1);
+    logPut(r, s, len);
+}
+
+#if ENABLE_SERIAL_DEBUG
+
+// Each record is stored behind a length byte that is not sent, so the
+// drain can hand the USART whole records only
+static uint8_t g_ring[LOG_RING_SIZE];
+static uint8_t g_head = 0; // next write
+static uint8_t g_tail = 0; // next length byte
+static uint8_t g_used = 0;
+static uint16_t g_dropped = 0;
+
+static void push(const uint8_t *p, uint8_t n)
+{
+    g_ring[g_head] = n;
+    g_head = (uint8_t)((g_head + 1) & (LOG_RING_SIZE - 1));
+    while (n--)
+    {
+        g_ring[g_head] = *p++;
+        g_head = (uint8_t)((g_head + 1) & (LOG_RING_SIZE - 1));
+    }
+}
+
+void dbgLogCommit(const LogRecord &r)
+{
+    if (g_dropped)
+    {
+        // Report the loss first, once there is room for the report too
+        LogRecord d;
+        d.n = 2;
+        d.b[0] = LOG_SYNC;
+        d.b[1] = LOG_DROPPED;
+        logArg(d, g_dropped);
+        if (LOG_RING_SIZE - g_used < 1 + d.n + 1 + r.n)
+        {
+            g_dropped++;
+            return;
+        }
+        push(d.b, d.n);
+        g_used += 1 + d.n;
+        g_dropped = 0;
+    }
+    if (LOG_RING_SIZE - g_used < 1 + r.n)
+    {
+        g_dropped++;
+        return;
+    }
+    push(r.b, r.n);
+    g_used += 1 + r.n;
+}
+
+void dbgLogDrain()
+{
+    // Whole records only: a reply written to uart meanwhile must not land
+    // inside one
+    while (g_used && uart.availableForWrite() >= g_ring[g_tail])
+    {
+        uint8_t n = g_ring[g_tail];
+        g_tail = (uint8_t)((g_tail + 1) & (LOG_RING_SIZE - 1));
+        g_used = (uint8_t)(g_used - 1 - n);
+        while (n--)
+        {
+            uart.write(g_ring[g_tail]);
+            g_tail = (uint8_t)((g_tail + 1) & (LOG_RING_SIZE - 1));
+        }
+    }
+}
+
+void dbgLogSettle()
+{
+    // Idle between UDRE interrupts rather than spin; Timer0 bounds each wait
+    set_sleep_mode(SLEEP_MODE_IDLE);
+    for (;;)
+    {
+        dbgLogDrain();
+        if (!g_used)
+            break;
+        sleep_mode();
+    }
+    uart.flush();
+}
+
+#else
+
+void dbgLogCommit(const LogRecord &) {}
+void dbgLogDrain() {}
+void dbgLogSettle() {}
+
+#endif
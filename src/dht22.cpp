@@ -0,0 +1,56 @@
+#include "dht22.h"
+#include <util/atomic.h>
+#include "fast_gpio.h"
+
+#define DHT22_START_LOW_US 1100 // host start signal: >= 1 ms low
+#define DHT22_RELEASE_US 55     // sensor answers 20-40 us after release
+#define DHT22_TIMEOUT 0xFFFF
+#define DHT22_MAX_LOOPS (F_CPU / 8000UL) // ~1 ms of polling (loop is ~8 cycles)
+
+// Polling iterations spent at level, DHT22_TIMEOUT if it never changed
+static uint16_t pulse(bool level)
+{
+    uint16_t n = 0;
+    while (PinDhtData::read() == level)
+    {
+        if (++n >= DHT22_MAX_LOOPS)
+            return DHT22_TIMEOUT;
+    }
+    return n;
+}
+
+void dht22Begin() { PinDhtData::inputPullup(); }
+
+bool dht22Read(int16_t *tenthsC, int16_t *tenthsRh)
+{
+    uint8_t data[5] = {0, 0, 0, 0, 0};
+    bool ok = true;
+
+    PinDhtData::low();
+    PinDhtData::output();
+    delayMicroseconds(DHT22_START_LOW_US);
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        PinDhtData::inputPullup();
+        delayMicroseconds(DHT22_RELEASE_US);
+        // Response: 80 us low, 80 us high
+        if (pulse(LOW) == DHT22_TIMEOUT || pulse(HIGH) == DHT22_TIMEOUT)
+            ok = false;
+        // 40 bits: 50 us low, then high for 26-28 us (0) or 70 us (1);
+        // decided against the low phase so the loop speed cancels out
+        for (uint8_t i = 0; ok && i < 40; i++)
+        {
+            uint16_t lo = pulse(LOW);
+            uint16_t hi = pulse(HIGH);
+            if (lo == DHT22_TIMEOUT || hi == DHT22_TIMEOUT)
+                ok = false;
+            data[i >> 3] = (uint8_t)((data[i >> 3] << 1) | (hi > lo));
+        }
+    }
+    if (!ok || (uint8_t)(data[0] + data[1] + data[2] + data[3]) != data[4])
+        return false;
+    *tenthsRh = (int16_t)(((uint16_t)data[0] << 8) | data[1]);
+    int16_t t = (int16_t)(((uint16_t)(data[2] & 0x7F) << 8) | data[3]);
+    *tenthsC = (data[2] & 0x80) ? (int16_t)-t : t; // sign-magnitude
+    return true;
+}
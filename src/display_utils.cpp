@@ -1,15 +1,17 @@
 #include <Arduino.h>
 #include "globals.h"
+#include "lcd_framebuffer.h"
+#include "cycle_profiler.h"
 
 // Print and pad/truncate to exactly 16 chars
-void lcdPrint16(const char *s)
+void lcdPrint16(uint8_t row, const char *s)
 {
-    char b[17];
+    PROF_SCOPE(PR_LCD_PRINT);
+    char b[LCD_COLS];
     uint8_t i = 0;
-    for (; i < 16 && s[i]; ++i)
+    for (; i < LCD_COLS && s[i]; ++i)
         b[i] = s[i];
-    for (; i < 16; ++i)
+    for (; i < LCD_COLS; ++i)
         b[i] = ' ';
-    b[16] = 0;
-    lcd.print(b);
+    lcdFbWriteRow(row, b);
 }
@@ -0,0 +1,233 @@
+#include "ds3231.h"
+#include <Wire.h>
+#include <RTClib.h>
+#include "periph_power.h"
+#include "cpu_clock.h"
+#include "cycle_profiler.h"
+#include "wake_stats.h"
+#include "config.h"
+
+#define DS3231_ADDR 0x68
+#define REG_TIME 0x00
+#define REG_ALARM1 0x07 // shadow index 0
+#define REG_CONTROL 0x0E // shadow index 7
+#define REG_STATUS 0x0F
+#define SHADOW_LEN 8
+
+#define CTRL_A1IE 0x01
+#define CTRL_A2IE 0x02
+#define CTRL_INTCN 0x04
+#define CTRL_RS 0x18
+#define STATUS_EN32KHZ 0x08
+
+static uint8_t g_regs[SHADOW_LEN]; // 0x07..0x0E as last written/read
+static uint8_t g_status = 0;
+static uint32_t g_busBytes = 0;
+
+static uint8_t bcd(uint8_t v) { return (uint8_t)(((v / 10) << 4) | (v % 10)); }
+static uint8_t unbcd(uint8_t b) { return (uint8_t)((b >> 4) * 10 + (b & 0x0F)); }
+
+static uint8_t g_busClk = CPU_FULL; // core clock divider to restore after a transaction
+static uint32_t g_busStamp = 0;
+
+// TWI clock only for the duration of a transaction; a gated TWI must be
+// re-initialised (Wire.begin also restores the pull-ups and bus state).
+// The core runs divided meanwhile: the burst is bound by SCL, not the CPU.
+static void busOn()
+{
+    g_busStamp = wakeStatsPhaseBegin();
+    g_busClk = cpuClockSet(CPU_SHIFT_I2C);
+    if (periphAcquire(PERIPH_TWI))
+        Wire.begin();
+    // SCL = f_cpu / (16 + 2 * TWBR), prescaler 1 (twi_init): up to 400 kHz at the current clock
+    uint32_t f = F_CPU >> cpuClockShift();
+    TWBR = (f > 16UL * 400000UL) ? (uint8_t)((f / 400000UL - 16) / 2) : 0;
+}
+
+static void busOff()
+{
+    periphRelease(PERIPH_TWI);
+    cpuClockSet(g_busClk);
+    wakeStatsPhaseEnd(WP_I2C, g_busStamp);
+}
+
+static bool writeRegs(uint8_t reg, const uint8_t *data, uint8_t n)
+{
+    busOn();
+    Wire.beginTransmission(DS3231_ADDR);
+    Wire.write(reg);
+    Wire.write(data, n);
+    g_busBytes += 2 + n;
+    bool ok = Wire.endTransmission() == 0;
+    busOff();
+    return ok;
+}
+
+static bool readRegs(uint8_t reg, uint8_t *data, uint8_t n)
+{
+    busOn();
+    Wire.beginTransmission(DS3231_ADDR);
+    Wire.write(reg);
+    g_busBytes += 2;
+    bool ok = Wire.endTransmission(false) == 0; // repeated start
+    if (ok)
+    {
+        g_busBytes += 1 + n;
+        ok = Wire.requestFrom((uint8_t)DS3231_ADDR, n) == n;
+        for (uint8_t i = 0; ok && i < n; i++)
+            data[i] = Wire.read();
+    }
+    busOff();
+    return ok;
+}
+
+// Status write value: 1 leaves a flag alone, 0 clears it
+static uint8_t statusWriteValue(uint8_t clearFlags)
+{
+    return (uint8_t)((DS3231_STATUS_OSF | DS3231_STATUS_A2F | DS3231_STATUS_A1F | (g_status & STATUS_EN32KHZ)) & ~clearFlags);
+}
+
+// Write registers that differ from the shadow, plus the status flag clear.
+// One burst up to 0x0F costs 2 + (9 - first) bytes, two transactions cost
+// 2 + span + 3: pick the cheaper.
+static bool commit(const uint8_t *want, uint8_t clearFlags)
+{
+    int8_t first = -1, last = -1;
+    for (uint8_t i = 0; i < SHADOW_LEN; i++)
+    {
+        if (want[i] != g_regs[i])
+        {
+            if (first < 0)
+                first = i;
+            last = i;
+        }
+    }
+    bool ok = true;
+    uint8_t st = statusWriteValue(clearFlags);
+    if (first < 0)
+    {
+        if (clearFlags)
+            ok = writeRegs(REG_STATUS, &st, 1);
+    }
+    else
+    {
+        uint8_t span = last - first + 1;
+        uint8_t buf[SHADOW_LEN + 1];
+        if (clearFlags && (SHADOW_LEN - last - 1) <= 2)
+        {
+            // gap to 0x0F is short: rewrite it and include status
+            uint8_t n = SHADOW_LEN - first;
+            memcpy(buf, want + first, n);
+            buf[n] = st;
+            ok = writeRegs(REG_ALARM1 + first, buf, n + 1);
+        }
+        else
+        {
+            memcpy(buf, want + first, span);
+            ok = writeRegs(REG_ALARM1 + first, buf, span);
+            if (clearFlags)
+                ok = writeRegs(REG_STATUS, &st, 1) && ok;
+        }
+    }
+    if (ok)
+    {
+        memcpy(g_regs, want, SHADOW_LEN);
+        g_status &= ~clearFlags;
+    }
+    return ok;
+}
+
+bool ds3231Begin()
+{
+    Wire.setClock(400000UL); // DS3231 supports fast-mode I2C
+    uint8_t buf[SHADOW_LEN + 1];
+    if (!readRegs(REG_ALARM1, buf, sizeof(buf)))
+        return false;
+    memcpy(g_regs, buf, SHADOW_LEN);
+    g_status = buf[SHADOW_LEN];
+    return true;
+}
+
+bool ds3231ReadTimeStatus(uint32_t *epoch)
+{
+    PROF_SCOPE(PR_RTC_READ);
+    // 0x0F status, 0x10 aging, 0x11-0x12 temperature, wrap, 0x00-0x06 time
+    uint8_t b[11];
+    if (!readRegs(REG_STATUS, b, sizeof(b)))
+        return false;
+    g_status = b[0];
+    const uint8_t *t = b + 4;
+    DateTime dt(2000 + unbcd(t[6]), unbcd(t[5] & 0x1F), unbcd(t[4]),
+                unbcd(t[2] & 0x3F), unbcd(t[1]), unbcd(t[0] & 0x7F));
+    if (epoch)
+        *epoch = dt.unixtime();
+    return true;
+}
+
+uint8_t ds3231Status() { return g_status; }
+
+bool ds3231SetTime(uint32_t epoch)
+{
+    DateTime dt(epoch);
+    uint8_t t[7] = {bcd(dt.second()), bcd(dt.minute()), bcd(dt.hour()), bcd(dt.dayOfTheWeek() + 1),
+                    bcd(dt.day()), bcd(dt.month()), bcd((uint8_t)(dt.year() - 2000))};
+    bool ok = writeRegs(REG_TIME, t, sizeof(t));
+    uint8_t st = statusWriteValue(DS3231_STATUS_OSF);
+    if (ok && writeRegs(REG_STATUS, &st, 1))
+        g_status &= ~DS3231_STATUS_OSF;
+    return ok;
+}
+
+bool ds3231SetSqw1Hz()
+{
+    uint8_t want[SHADOW_LEN];
+    memcpy(want, g_regs, SHADOW_LEN);
+    want[REG_CONTROL - REG_ALARM1] &= ~(CTRL_INTCN | CTRL_RS | CTRL_A1IE | CTRL_A2IE);
+    return commit(want, DS3231_STATUS_A1F | DS3231_STATUS_A2F);
+}
+
+bool ds3231SetAlarms(uint32_t a1Epoch, uint32_t a2Epoch)
+{
+    uint8_t want[SHADOW_LEN];
+    memcpy(want, g_regs, SHADOW_LEN);
+    // A1M1-A1M4 = 0, DY/DT = 0: match date, hours, minutes, seconds
+    DateTime a1(a1Epoch);
+    want[0] = bcd(a1.second());
+    want[1] = bcd(a1.minute());
+    want[2] = bcd(a1.hour());
+    want[3] = bcd(a1.day());
+    uint8_t &ctrl = want[REG_CONTROL - REG_ALARM1];
+    ctrl |= CTRL_INTCN | CTRL_A1IE;
+    if (a2Epoch)
+    {
+        // A2M2-A2M4 = 0, DY/DT = 0: match date, hours, minutes (seconds = 00)
+        DateTime a2(a2Epoch);
+        want[4] = bcd(a2.minute());
+        want[5] = bcd(a2.hour());
+        want[6] = bcd(a2.day());
+        ctrl |= CTRL_A2IE;
+    }
+    else
+        ctrl &= ~CTRL_A2IE;
+    return commit(want, DS3231_STATUS_A1F | DS3231_STATUS_A2F);
+}
+
+bool ds3231SetMinuteAlarm()
+{
+    uint8_t want[SHADOW_LEN];
+    memcpy(want, g_regs, SHADOW_LEN);
+    // A2M2-A2M4 = 1: Alarm2 fires every minute at seconds = 00
+    want[4] = 0x80;
+    want[5] = 0x80;
+    want[6] = 0x80;
+    uint8_t &ctrl = want[REG_CONTROL - REG_ALARM1];
+    ctrl = (uint8_t)((ctrl & ~(CTRL_RS | CTRL_A1IE)) | CTRL_INTCN | CTRL_A2IE);
+    return commit(want, DS3231_STATUS_A1F | DS3231_STATUS_A2F);
+}
+
+bool ds3231ClearAlarmFlags()
+{
+    return commit(g_regs, DS3231_STATUS_A1F | DS3231_STATUS_A2F); // status byte only
+}
+
+uint32_t ds3231BusBytes() { return g_busBytes; }
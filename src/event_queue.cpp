@@ -0,0 +1,42 @@
+#include "event_queue.h"
+
+static WakeEvent g_ring[EVENT_QUEUE_LEN];
+static volatile uint8_t g_head = 0; // next slot to fill (ISR)
+static volatile uint8_t g_tail = 0; // next slot to read (loop)
+static volatile uint8_t g_dropped = 0;
+static uint16_t g_maxLatencyUs = 0;
+
+static inline uint16_t stampNow() { return (uint16_t)(micros() >> 2); }
+
+void eventQueuePush(uint8_t pin, uint8_t edge)
+{
+    uint8_t head = g_head;
+    uint8_t next = (uint8_t)((head + 1) & (EVENT_QUEUE_LEN - 1));
+    if (next == g_tail)
+    {
+        if (g_dropped != 0xFF)
+            g_dropped++;
+        return;
+    }
+    g_ring[head].pin = pin;
+    g_ring[head].edge = edge;
+    g_ring[head].stamp = stampNow();
+    g_head = next; // publish after the record is complete
+}
+
+bool eventQueuePop(WakeEvent *out)
+{
+    uint8_t tail = g_tail;
+    if (tail == g_head)
+        return false;
+    *out = g_ring[tail];
+    g_tail = (uint8_t)((tail + 1) & (EVENT_QUEUE_LEN - 1));
+    uint16_t lat = (uint16_t)(stampNow() - out->stamp);
+    if (lat < 0x4000U && (uint16_t)(lat * 4U) > g_maxLatencyUs)
+        g_maxLatencyUs = (uint16_t)(lat * 4U);
+    return true;
+}
+
+bool eventQueuePending() { return g_tail != g_head; }
+uint8_t eventQueueDropped() { return g_dropped; }
+uint16_t eventQueueMaxLatencyUs() { return g_maxLatencyUs; }
@@ -0,0 +1,78 @@
+#include "hd44780_fast.h"
+#include "fast_gpio.h"
+#include "cpu_clock.h"
+
+// Enable pulse width / cycle: PWeh >= 450 ns, tcycE >= 1 us
+#define LCD_EN_HOLD_CYCLES (F_CPU / 2000000UL)
+
+void Hd44780Fast::writeNibble(uint8_t nibble)
+{
+    PinLcdD4::write(nibble & 0x01);
+    PinLcdD5::write(nibble & 0x02);
+    PinLcdD6::write(nibble & 0x04);
+    PinLcdD7::write(nibble & 0x08);
+    PinLcdEn::high();
+    __builtin_avr_delay_cycles(LCD_EN_HOLD_CYCLES);
+    PinLcdEn::low(); // data latched on falling edge
+    __builtin_avr_delay_cycles(LCD_EN_HOLD_CYCLES);
+}
+
+void Hd44780Fast::send(uint8_t value, bool rs)
+{
+    PinLcdRs::write(rs);
+    writeNibble(value >> 4);
+    writeNibble(value & 0x0F);
+    cpuClockDelayUs(LCD_EXEC_US); // callers may run the core divided (lcd_framebuffer)
+}
+
+void Hd44780Fast::command(uint8_t value) { send(value, false); }
+
+size_t Hd44780Fast::write(uint8_t value)
+{
+    send(value, true);
+    return 1;
+}
+
+void Hd44780Fast::begin(uint8_t cols, uint8_t rows)
+{
+    (void)cols;
+    (void)rows; // geometry fixed at 16x2 (row 1 at DDRAM 0x40)
+    PinLcdRs::output();
+    PinLcdEn::output();
+    PinLcdD4::output();
+    PinLcdD5::output();
+    PinLcdD6::output();
+    PinLcdD7::output();
+    PinLcdRs::low();
+    PinLcdEn::low();
+    delay(50); // > 40 ms after Vcc rises to 2.7 V
+
+    // Datasheet 4-bit initialization by instruction
+    writeNibble(0x03);
+    delayMicroseconds(4500);
+    writeNibble(0x03);
+    delayMicroseconds(150);
+    writeNibble(0x03);
+    delayMicroseconds(LCD_EXEC_US);
+    writeNibble(0x02); // 4-bit interface
+    delayMicroseconds(LCD_EXEC_US);
+
+    command(0x28); // function set: 4-bit, 2 lines, 5x8
+    display();
+    clear();
+    command(0x06); // entry mode: increment, no shift
+}
+
+void Hd44780Fast::clear()
+{
+    command(0x01);
+    cpuClockDelayUs(LCD_CLEAR_US);
+}
+
+void Hd44780Fast::setCursor(uint8_t col, uint8_t row)
+{
+    command(0x80 | (uint8_t)(col + (row ? 0x40 : 0x00)));
+}
+
+void Hd44780Fast::display() { command(0x0C); }   // display on, cursor off, blink off
+void Hd44780Fast::noDisplay() { command(0x08); } // display off (DDRAM retained)
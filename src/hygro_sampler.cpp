@@ -0,0 +1,131 @@
+#include "hygro_sampler.h"
+#include "dht22.h"
+#include "sleep_utils.h"
+#include "debug.h"
+#include "fast_gpio.h"
+#include "cpu_clock.h"
+#include "deadline.h"
+#include "wake_stats.h"
+
+enum SamplerPhase : uint8_t
+{
+    SP_OFF = 0,
+    SP_SETTLING,
+    SP_RETRY_WAIT,
+    SP_DONE
+};
+
+static SamplerPhase g_phase = SP_OFF;
+static uint16_t g_waitMs = 0;    // wait still owed at g_markMs
+static uint32_t g_markMs = 0;    // deadlineNow() when g_waitMs was last set
+static bool g_retried = false;
+static int16_t g_tc = DHT22_NO_READING; // 0.1 degC
+static int16_t g_rh = DHT22_NO_READING; // 0.1 %RH
+static uint32_t g_pwrAt = 0;            // deadlineNow() at power-up
+static uint32_t g_pwrMs = 0;            // completed powered periods
+static uint16_t g_pwrUps = 0;
+
+static void startWait(uint16_t ms)
+{
+    g_waitMs = ms;
+    g_markMs = deadlineNow();
+}
+
+void hygroSamplerPowerUp()
+{
+    PinDhtPwr::high();
+    if (g_phase == SP_OFF)
+    {
+        g_pwrAt = deadlineNow();
+        g_pwrUps++;
+    }
+    dht22Begin();
+    g_phase = SP_SETTLING;
+    g_retried = false;
+    g_tc = g_rh = DHT22_NO_READING;
+    startWait(DHT_SETTLE_MS);
+}
+
+void hygroSamplerStart()
+{
+    if (g_phase == SP_OFF)
+    {
+        hygroSamplerPowerUp();
+        return;
+    }
+    if (g_phase == SP_DONE)
+    {
+        // Sensor stayed powered since the last sample: already settled
+        g_phase = SP_SETTLING;
+        g_retried = false;
+        g_tc = g_rh = DHT22_NO_READING;
+        startWait(0);
+    }
+    // SP_SETTLING: pre-warmed ahead of the grid, keep the remaining wait
+}
+
+void hygroSamplerPowerDown()
+{
+    PinDhtPwr::low();
+    PinDhtData::input(); // no pull-up feeding the unpowered sensor
+    if (g_phase != SP_OFF)
+        g_pwrMs += deadlineNow() - g_pwrAt;
+    g_phase = SP_OFF;
+}
+
+bool hygroSamplerIsPowered() { return g_phase != SP_OFF; }
+
+uint32_t hygroSamplerPoweredMs() { return (g_phase != SP_OFF) ? g_pwrMs + (deadlineNow() - g_pwrAt) : g_pwrMs; }
+
+uint16_t hygroSamplerPowerUps() { return g_pwrUps; }
+
+uint16_t hygroSamplerWaitMs()
+{
+    if (g_phase != SP_SETTLING && g_phase != SP_RETRY_WAIT)
+        return 0;
+    // Awake work and credited sleep both count; interrupted sleeps are
+    // credited short, so the settle can run long but never short
+    uint32_t elapsed = deadlineNow() - g_markMs;
+    return (elapsed >= g_waitMs) ? 0 : (uint16_t)(g_waitMs - elapsed);
+}
+
+bool hygroSamplerStep()
+{
+    if (g_phase == SP_OFF || g_phase == SP_DONE)
+        return true;
+    if (hygroSamplerWaitMs() > 0)
+        return false;
+    // The bit-bang counts pulse widths in F_CPU polling loops
+    uint8_t clk = cpuClockSet(CPU_FULL);
+    uint32_t t0 = wakeStatsPhaseBegin();
+    bool ok = dht22Read(&g_tc, &g_rh);
+    wakeStatsPhaseEnd(WP_DHT, t0);
+    cpuClockSet(clk);
+    if (!ok)
+        g_tc = g_rh = DHT22_NO_READING;
+    if (!ok && !g_retried)
+    {
+        DBG_LOG(LOG_HYGRO_RETRY);
+        g_retried = true;
+        g_phase = SP_RETRY_WAIT;
+        startWait(DHT_RETRY_MS);
+        return false;
+    }
+    g_phase = SP_DONE;
+    return true;
+}
+
+uint16_t hygroSamplerRun()
+{
+    uint16_t slept = 0;
+    while (!hygroSamplerStep())
+    {
+        uint16_t s = sleepPowerDownMs(hygroSamplerWaitMs());
+        deadlineCreditSleep(s);
+        slept += s;
+    }
+    return slept;
+}
+
+int16_t hygroSamplerTemperature() { return g_tc; }
+int16_t hygroSamplerHumidity() { return g_rh; }
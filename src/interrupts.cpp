@@ -1,15 +1,26 @@
 #include "interrupts.h"
 #include "debug.h"
+#include "fast_gpio.h"
+#include "event_queue.h"
 
 extern AppState g_app;
 extern RTC_DS3231 rtc; // still provided by main
 
+// PCINT wiring used below must match pins.h
+static_assert(PinModeSwitch::pcintGroup() == 2 && PinModeSwitch::pcintMask() == _BV(PCINT20),
+              "PCINT20 (PCMSK2) must be MODE_PIN");
+static_assert(PinSqw::pcintGroup() == 2 && PinSqw::pcintMask() == _BV(PCINT21),
+              "PCINT21 (PCMSK2) must be SQW_PIN");
+static_assert(PinSerialRx::pcintGroup() == 2 && PinSerialRx::pcintMask() == _BV(PCINT16),
+              "PCINT16 (PCMSK2) must be SERIAL_RX_PIN");
+static_assert(PinBlButton::pcintGroup() == 0 && PinBlButton::pcintMask() == _BV(PCINT2),
+              "PCINT2 (PCMSK0) must be BL_BUTTON_PIN");
+
 void interruptsInitCorePins()
 {
     g_app.lastPinsD = PIND;                               // capture first
     PCMSK2 |= _BV(PCINT20) | _BV(PCINT21) | _BV(PCINT16); // D4, D5, D0(RX)
     PCICR |= _BV(PCIE2);
-    interruptsClearWakeFlags();
 }
 
 void interruptsEnableTick(bool en)
@@ -18,7 +29,6 @@ void interruptsEnableTick(bool en)
         PCMSK2 |= _BV(PCINT21);
     else
         PCMSK2 &= ~_BV(PCINT21);
-    g_app.tickWake = false;
 }
 
 void interruptsInitBacklightButton()
@@ -26,7 +36,6 @@ void interruptsInitBacklightButton()
     g_app.lastPinsB = PINB;
     PCMSK0 |= _BV(PCINT2); // D10
     PCICR |= _BV(PCIE0);
-    g_app.blButtonWake = false;
 }
 
 void interruptsMaskSwitch(bool mask)
@@ -37,38 +46,50 @@ void interruptsMaskSwitch(bool mask)
         PCMSK2 |= _BV(PCINT20); // enable D4
 }
 
+void interruptsMaskSerialRx(bool mask)
+{
+    if (mask)
+        PCMSK2 &= ~_BV(PCINT16); // USART receives on its own while awake
+    else
+        PCMSK2 |= _BV(PCINT16); // wake source while powered down
+}
+
 // ------------ ISRs -------------
+// Each edge of interest becomes one queued event (event_queue); loop()
+// drains them all after the wake.
 ISR(PCINT2_vect)
 {
     uint8_t now = PIND;
     uint8_t changed = now ^ g_app.lastPinsD;
     g_app.lastPinsD = now;
-    if (changed & _BV(PD4))
-        g_app.switchWake = true; // slide
-    if (changed & _BV(PD5))
+    if (changed & PinModeSwitch::mask())
+        eventQueuePush(MODE_PIN, (now & PinModeSwitch::mask()) ? EDGE_RISE : EDGE_FALL); // slide
+    if (changed & PinSqw::mask())
     {
-        if (g_app.currentMode == MODE_CLOCK)
-        {
-            if (now & _BV(PD5))
-                g_app.tickWake = true; // rising
-        }
-        else
+        bool rising = now & PinSqw::mask();
+        if (g_app.sqwCounting) // clock mode, 1 Hz square wave
         {
-            if (!(now & _BV(PD5)))
-                g_app.tickWake = true; // falling
+            if (rising)
+            {
+                g_app.sqwEpoch++;
+                g_app.sqwEdges++;
+                eventQueuePush(SQW_PIN, EDGE_RISE); // 1 Hz tick
+            }
         }
+        else if (!rising)
+            eventQueuePush(SQW_PIN, EDGE_FALL); // alarm INT asserted (hygro grid / clock minute)
     }
-    if (changed & _BV(PD0))
-        g_app.serialWake = true; // RX
+    if (changed & PinSerialRx::mask())
+        eventQueuePush(SERIAL_RX_PIN, (now & PinSerialRx::mask()) ? EDGE_RISE : EDGE_FALL); // RX
 }
 
 ISR(PCINT0_vect)
 {
     uint8_t now = PINB, ch = now ^ g_app.lastPinsB;
     g_app.lastPinsB = now;
-    if (ch & _BV(PB2))
+    if (ch & PinBlButton::mask())
     {
-        if ((now & _BV(PB2)) == 0)
-            g_app.blButtonWake = true; // LOW press
+        if ((now & PinBlButton::mask()) == 0)
+            eventQueuePush(BL_BUTTON_PIN, EDGE_FALL); // LOW press
     }
 }
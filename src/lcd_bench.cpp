@@ -0,0 +1,45 @@
+#include "lcd_bench.h"
+
+#if ENABLE_LCD_BENCH
+#include <LiquidCrystal.h>
+#include "globals.h"
+#include "lcd_framebuffer.h"
+#include "serial_port.h"
+
+#define LCD_BENCH_ROUNDS 20
+
+static const char kRow0[] = "0123456789ABCDEF";
+static const char kRow1[] = "fedcba9876543210";
+
+template <class Lcd>
+static unsigned long timeFullRefresh(Lcd &l)
+{
+    unsigned long t0 = micros();
+    for (uint8_t i = 0; i < LCD_BENCH_ROUNDS; i++)
+    {
+        l.setCursor(0, 0);
+        l.write(kRow0, 16);
+        l.setCursor(0, 1);
+        l.write(kRow1, 16);
+    }
+    return (micros() - t0) / LCD_BENCH_ROUNDS;
+}
+
+void lcdBenchRun()
+{
+    LiquidCrystal ref(LCD_RS, LCD_EN, LCD_D4, LCD_D5, LCD_D6, LCD_D7);
+    ref.begin(16, 2);
+    unsigned long usRef = timeFullRefresh(ref);
+
+    lcd.begin(16, 2);
+    unsigned long usFast = timeFullRefresh(lcd);
+
+    uart.print(F("[BENCH] LCD full refresh us: LiquidCrystal="));
+    uart.print(usRef);
+    uart.print(F(" fast="));
+    uart.println(usFast);
+
+    lcd.clear();
+    lcdFbReset();
+}
+#endif
@@ -0,0 +1,66 @@
+#include "lcd_framebuffer.h"
+#include "globals.h"
+#include "config.h"
+#include "cpu_clock.h"
+#include "wake_stats.h"
+
+static char g_shadow[LCD_ROWS][LCD_COLS];
+static uint8_t g_curRow = 0xFF; // HD44780 address counter as we left it
+static uint8_t g_curCol = 0xFF;
+
+void lcdFbReset()
+{
+    memset(g_shadow, ' ', sizeof(g_shadow));
+    g_curRow = 0;
+    g_curCol = 0; // clear() homes the cursor
+}
+
+void lcdFbWriteRow(uint8_t row, const char *text)
+{
+    if (row >= LCD_ROWS)
+        return;
+    char *sh = g_shadow[row];
+    uint8_t c = 0;
+    uint8_t clk = 0xFF; // divided on the first changed cell: the bus writes wait on the LCD anyway
+    uint32_t t0 = 0;
+    while (c < LCD_COLS)
+    {
+        if (sh[c] == text[c])
+        {
+            c++;
+            continue;
+        }
+        // Extend the run across single unchanged cells: rewriting one cell
+        // costs the same bus write as a fresh setCursor.
+        uint8_t end = c + 1;
+        while (end < LCD_COLS)
+        {
+            if (sh[end] != text[end])
+                end++;
+            else if (end + 1 < LCD_COLS && sh[end + 1] != text[end + 1])
+                end += 2;
+            else
+                break;
+        }
+        if (clk == 0xFF)
+        {
+            t0 = wakeStatsPhaseBegin();
+            clk = cpuClockSet(CPU_SHIFT_LCD);
+        }
+        if (g_curRow != row || g_curCol != c)
+            lcd.setCursor(c, row);
+        for (uint8_t i = c; i < end; i++)
+        {
+            lcd.write((uint8_t)text[i]);
+            sh[i] = text[i];
+        }
+        g_curRow = row;
+        g_curCol = end;
+        c = end;
+    }
+    if (clk != 0xFF)
+    {
+        cpuClockSet(clk);
+        wakeStatsPhaseEnd(WP_LCD, t0);
+    }
+}
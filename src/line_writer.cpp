@@ -0,0 +1,58 @@
+#include "line_writer.h"
+
+LineWriter::LineWriter(char *buf, size_t n) : buf_(buf), p_(buf), last_(buf + (n ? n - 1 : 0))
+{
+    if (n)
+        *p_ = 0;
+}
+
+LineWriter &LineWriter::ch(char c)
+{
+    if (p_ < last_)
+    {
+        *p_++ = c;
+        *p_ = 0;
+    }
+    return *this;
+}
+
+LineWriter &LineWriter::str(const char *s)
+{
+    while (*s)
+        ch(*s++);
+    return *this;
+}
+
+// Digits are produced least significant first into a small scratch buffer
+// (10 digits + point + sign), then emitted behind the padding.
+LineWriter &LineWriter::digits(uint32_t a, bool neg, uint8_t decimals, uint8_t width, char fill)
+{
+    char tmp[12];
+    uint8_t n = 0;
+    uint8_t d = 0;
+    do
+    {
+        tmp[n++] = (char)('0' + a % 10);
+        a /= 10;
+        if (++d == decimals)
+            tmp[n++] = '.';
+    } while (a || d <= decimals);
+    if (neg)
+        tmp[n++] = '-';
+    for (uint8_t i = n; i < width; i++)
+        ch(fill);
+    while (n)
+        ch(tmp[--n]);
+    return *this;
+}
+
+LineWriter &LineWriter::num(uint32_t v, uint8_t width, char fill)
+{
+    return digits(v, false, 0, width, fill);
+}
+
+LineWriter &LineWriter::fixed(int32_t v, uint8_t decimals, uint8_t width)
+{
+    bool neg = v < 0;
+    return digits(neg ? (uint32_t)-v : (uint32_t)v, neg, decimals, width, ' ');
+}
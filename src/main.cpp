@@ -1,13 +1,9 @@
 // Core Arduino & libs
 #include <Arduino.h>
-#include <LiquidCrystal.h>
-#include <DHT.h>
 #include <RTClib.h>
-#include <LowPower.h>
 #include <avr/interrupt.h>
 #include <ctype.h>
 #include <string.h>
-#include <math.h>
 
 // Modular headers
 #include "config.h"
@@ -22,22 +18,31 @@
 #include "interrupts.h"
 #include "globals.h"
 #include "display_utils.h"
+#include "lcd_framebuffer.h"
+#include "lcd_bench.h"
 #include "modes.h"
+#include "hygro_sampler.h"
+#include "fast_gpio.h"
+#include "ds3231.h"
+#include "sleep_utils.h"
+#include "deadline.h"
+#include "serial_port.h"
+#include "event_queue.h"
+#include "periph_power.h"
+#include "wake_stats.h"
+#include "cycle_profiler.h"
 
 // All configuration/constants in headers; this file orchestrates modes & main loop.
 
-LiquidCrystal lcd(LCD_RS, LCD_EN, LCD_D4, LCD_D5, LCD_D6, LCD_D7);
-DHT dht(DHTPIN, DHTTYPE);
+Hd44780Fast lcd; // pins resolved at compile time from pins.h
 RTC_DS3231 rtc;
 AppState g_app; // global runtime state (see app_state.h)
 
 // ---------- Forward declarations ----------
 // (moved update/enter functions live in modes.*)
-void sleepUntilAlarmOrSwitch();
-bool sleepUntilNextOrSwitch(uint16_t remainSec, uint16_t *sleptSecOut);
+void sleepUntilDeadlineOrWake();
 void rtc_use_sqw_for_clock();
 // (rtc_use_alarm_for_hygro now internal to scheduler)
-void drainSerial(unsigned long ms = 250);
 
 // ---------- Small helpers ----------
 // lcdPrint16 moved to display_utils.cpp
@@ -51,16 +56,105 @@ void drainSerial(unsigned long ms = 250);
 // (RTC print / parsing utilities now in time_commands module)
 
 // (Time command parsing moved to time_commands module)
-void drainSerial(unsigned long ms)
+
+// Serial keep-awake window: idle sleep until a command line, a wake event
+// or the earliest deadline (the window's own end at the latest).
+static void serialIdleWait()
+{
+  interruptsMaskSerialRx(true); // the USART is clocked; no PCINT per RX edge
+  uint32_t waitMs = deadlineMsToNext();
+  sleepIdleUntilLine(waitMs > 0xFFFFUL ? 0xFFFFU : (uint16_t)waitMs);
+}
+
+// USART clock only while the serial window is open (periph_power)
+static void serialWindowHold(bool open)
+{
+  static bool held = false;
+  if (open == held)
+    return;
+  if (!open)
+    uart.flush(); // last reply out before the clock stops
+  serialPortHold(open);
+  held = open;
+}
+
+// Last counted 1 Hz SQW edge: raw count (g_app.sqwEdges) and its
+// deadlineNow() time, back-dated by the event's queueing latency
+static bool g_tickRefValid = false;
+static uint8_t g_tickRefEdges = 0;
+static uint32_t g_tickRefMs = 0;
+
+static void noteSqwTick(uint16_t stamp)
 {
-  unsigned long t0 = millis();
-  while ((long)(millis() - t0) < (long)ms)
+  uint16_t age = (uint16_t)((micros() >> 2) - stamp); // 4 us units
+  g_tickRefEdges = g_app.sqwEdges;
+  g_tickRefMs = deadlineNow() - (uint32_t)age * 4UL / 1000UL;
+  g_tickRefValid = true;
+}
+
+// What the PCINT ISRs queued since the last pass (event_queue), batched
+struct WakeSummary
+{
+  bool slide, tick, alarm, button, serial;
+};
+
+static WakeSummary drainWakeEvents()
+{
+  WakeSummary w = {false, false, false, false, false};
+  WakeEvent ev;
+  uint16_t tickStamp = 0;
+  while (eventQueuePop(&ev))
   {
-    timeCommandsHandle();
-    if (!Serial.available())
-      delay(2);
+    if (ev.pin == MODE_PIN)
+      w.slide = true;
+    else if (ev.pin == SQW_PIN && ev.edge == EDGE_RISE)
+    {
+      w.tick = true; // 1 Hz SQW
+      tickStamp = ev.stamp;
+    }
+    else if (ev.pin == SQW_PIN)
+      w.alarm = true; // INT asserted: hygro grid / clock minute
+    else if (ev.pin == BL_BUTTON_PIN)
+      w.button = true;
+    else if (ev.pin == SERIAL_RX_PIN)
+      w.serial = true;
   }
-  g_app.serialWake = false;
+  if (w.serial)
+  {
+    // Clock the USART before any I2C/LCD/DHT work: bytes arriving
+    // meanwhile would otherwise hit a gated receiver and be lost
+    serialWindowHold(true);
+    interruptsMaskSerialRx(true);
+  }
+  if (w.tick)
+  {
+    wakeStatsSource(WS_TICK);
+    noteSqwTick(tickStamp);
+    timebaseOnSqwTick(); // resync in phase with the edge
+    DBG_LOG(LOG_WAKE_TICK);
+  }
+  if (w.alarm)
+  {
+    wakeStatsSource(WS_ALARM);
+    timebaseInvalidate(); // re-read the DS3231 flags
+    DBG_LOG(LOG_WAKE_ALARM);
+  }
+  if (w.slide)
+  {
+    wakeStatsSource(WS_SLIDE);
+    DBG_LOG(LOG_WAKE_SLIDE);
+  }
+  if (w.button)
+  {
+    wakeStatsSource(WS_BUTTON);
+    DBG_LOG(LOG_WAKE_BUTTON);
+  }
+  if (w.serial)
+  {
+    wakeStatsSource(WS_SERIAL);
+    DBG_LOG(LOG_WAKE_SERIAL);
+  }
+  return w;
 }
 
 // ---------- DS3231 helpers ----------
@@ -71,74 +165,76 @@ void drainSerial(unsigned long ms)
 // ---------- Mode enter/update ----------
 // enterMode moved to modes.cpp
 
-// Hygro: sleep until alarm (INT low) or user action
-void sleepUntilAlarmOrSwitch()
+// Interrupted sleep still to be credited: RTC epoch before it (see below)
+static bool g_sleepCreditPending = false;
+static uint32_t g_sleepEpoch0 = 0;
+
+// Credit an interrupted power-down from the DS3231 (seconds not counted).
+// The read before the sleep is cached and not aligned to the seconds
+// rollover, so the difference can be a second more than really passed;
+// one second is held back and each such sleep is credited up to 2 s
+// short, never long. Called once per wake after drainWakeEvents(); its
+// timebaseNow() is the read the rest of the pass uses anyway.
+static void creditInterruptedSleep()
 {
-  DBG_FLUSH();
-  g_app.tickWake = false; // wait for fresh falling edge
-  while (!g_app.tickWake && !g_app.switchWake && !g_app.blButtonWake && !g_app.serialWake)
-  {
-    LowPower.powerDown(SLEEP_8S, ADC_OFF, BOD_OFF);
-    if (g_app.tickWake || g_app.switchWake || g_app.blButtonWake || g_app.serialWake)
-      break;
-    if (g_app.rtcAvailable)
-    {
-      uint32_t nowEpoch = rtc.now().unixtime();
-      if (hygroSchedulerFailsafeCheck(nowEpoch))
-      {
-        updateHygroMode();
-        hygroSchedulerMarkSample(nowEpoch);
-        break;
-      }
-    }
-  }
-  if (g_app.tickWake)
-    DBG_PRINTLN(F("[WAKE] Alarm/INT"));
-  else if (g_app.switchWake)
-    DBG_PRINTLN(F("[WAKE] Slide"));
-  else if (g_app.blButtonWake)
-    DBG_PRINTLN(F("[WAKE] Backlight btn"));
-  else if (g_app.serialWake)
-    DBG_PRINTLN(F("[WAKE] Serial RX"));
+  if (!g_sleepCreditPending)
+    return;
+  g_sleepCreditPending = false;
+  uint32_t epoch1 = timebaseNow();
+  if (epoch1 > g_sleepEpoch0 + 1)
+    deadlineCreditSleep((epoch1 - g_sleepEpoch0 - 1) * 1000UL);
 }
 
-// Fallback when no RTC: chunked WDT sleep
-bool sleepUntilNextOrSwitch(uint16_t remainSec, uint16_t *sleptSecOut)
+// Credit an interrupted power-down while SQW edges are counted: the clock
+// moves up to the latest counted edge, i.e. the whole edges since the
+// reference less the time already spent awake after it. Edges are in
+// phase with the count, so nothing is held back.
+static void creditCountedSleep()
 {
-  uint16_t orig = remainSec;
-  g_app.tickWake = false;
-  while (remainSec > 0)
-  {
-    uint8_t c = (remainSec >= 8) ? 8 : (remainSec >= 4) ? 4
-                                   : (remainSec >= 2)   ? 2
-                                                        : 1;
-    LowPower.powerDown((c == 8) ? SLEEP_8S : (c == 4) ? SLEEP_4S
-                                         : (c == 2)   ? SLEEP_2S
-                                                      : SLEEP_1S,
-                       ADC_OFF, BOD_OFF);
-    if (g_app.switchWake || g_app.blButtonWake || g_app.tickWake || g_app.serialWake)
-      break;
-    remainSec -= c;
-  }
-  uint16_t slept = orig - remainSec;
-  if (sleptSecOut)
-    *sleptSecOut = slept;
-  g_app.tickWake = false;
-  return (remainSec == 0);
+  if (!g_tickRefValid)
+    return;
+  uint8_t edges = (uint8_t)(g_app.sqwEdges - g_tickRefEdges);
+  int32_t d = (int32_t)(g_tickRefMs + edges * 1000UL - deadlineNow());
+  if (d > 0)
+    deadlineCreditSleep((uint32_t)d);
 }
 
-// Clock: sleep until 1 Hz tick / slide / button / serial
-void sleepUntilTickOrSwitch()
+// Deepest sleep that still meets the earliest armed deadline (deadline.h).
+// Nothing armed: power down with the WDT off until the DS3231 (alarm INT, or
+// 1 Hz SQW while the clock shows seconds) or a pin change wakes us. Otherwise: the
+// longest WDT slice that does not overshoot it. The monotonic clock is
+// credited exactly for a completed slice, else from the counted SQW edges or
+// by creditInterruptedSleep() (nothing without an RTC: deadlines run late,
+// never early).
+void sleepUntilDeadlineOrWake()
 {
-  DBG_FLUSH();
-  g_app.tickWake = false;
-  while (!g_app.tickWake && !g_app.switchWake && !g_app.blButtonWake && !g_app.serialWake)
+  uint32_t waitMs = deadlineMsToNext();
+  if (waitMs == 0)
+    return; // overdue: service it first
+  if (g_app.rtcAvailable && !g_app.sqwCounting && !PinSqw::read())
+  {
+    timebaseInvalidate(); // INT already asserted: an alarm flag is still set, re-read it
+    return;
+  }
+  interruptsMaskSerialRx(false); // RX edge is the serial wake source while powered down
+  bool counted = g_app.sqwCounting;
+  uint32_t epoch0 = (g_app.rtcAvailable && !counted) ? timebaseNow() : 0;
+  uint16_t sliceMs = 0;
+  if (waitMs == DEADLINE_NONE)
+    sleepPowerDownUntilWake();
+  else
+    sliceMs = sleepPowerDownSliceMs(waitMs);
+  wakeStatsWake(); // sources are claimed by drainWakeEvents on the next pass
+
+  if (sliceMs == 0 && counted)
+    creditCountedSleep(); // no DS3231 read needed
+  else if (sliceMs == 0 && g_app.rtcAvailable)
   {
-    LowPower.powerDown(SLEEP_8S, ADC_OFF, BOD_OFF);
+    g_sleepEpoch0 = epoch0;
+    g_sleepCreditPending = true;
   }
-  if (g_app.tickWake)
-    DBG_PRINTLN(F("[WAKE] SQW 1Hz"));
-  g_app.tickWake = false;
+  else
+    deadlineCreditSleep(sliceMs);
 }
 
 // 12-hour Clock UI with AM/PM
@@ -149,43 +245,50 @@ void sleepUntilTickOrSwitch()
 // ---------- setup/loop ----------
 void setup()
 {
-  pinMode(DHT_PWR, OUTPUT);
-  digitalWrite(DHT_PWR, LOW);
-  pinMode(VBAT_PIN, INPUT);
-  pinMode(MODE_PIN, INPUT_PULLUP);
-  pinMode(SQW_PIN, INPUT_PULLUP);
-
-  pinMode(BL_BUTTON_PIN, INPUT_PULLUP); // button
+  periphInit(); // everything but Timer0 gated until a module acquires it
+#if ENABLE_CYCLE_PROFILER
+  profInit();
+#endif
+  PinDhtPwr::output();
+  PinDhtPwr::low();
+  PinVbat::input();
+  PinModeSwitch::inputPullup();
+  PinSqw::inputPullup();
+
+  PinBlButton::inputPullup(); // button
 
   DBG_BEGIN(115200);
-  DBG_PRINTLN(F("[BOOT]"));
+  DBG_LOG(LOG_BOOT, (uint32_t)LOG_CATALOG_HASH);
+
+  analogReference(DEFAULT); // Vcc measured against the bandgap in battery.cpp
 
-  analogReference(DEFAULT); // we measure Vcc dynamically in readVcc()
+#if ENABLE_LCD_BENCH
+  lcdBenchRun();
+#endif
 
   lcd.begin(16, 2);
+  lcdFbReset();
   delay(80);
-  lcd.setCursor(0, 0);
-  lcdPrint16("DIY Hygrometer ");
-  lcd.setCursor(0, 1);
-  lcdPrint16("LCD+DHT22+RTC  ");
+  lcdPrint16(0, "DIY Hygrometer ");
+  lcdPrint16(1, "LCD+DHT22+RTC  ");
   delay(800);
 
+  periphAcquire(PERIPH_TWI); // held across RTClib + DS3231 setup
   if (rtc.begin())
   {
     g_app.rtcAvailable = true;
+    ds3231Begin();
     if (rtc.lostPower())
-      rtc.adjust(DateTime(F(__DATE__), F(__TIME__)));
-    rtc.writeSqwPinMode(DS3231_SquareWave1Hz);
-    g_app.startTimeRTC = rtc.now();
+      ds3231SetTime(DateTime(F(__DATE__), F(__TIME__)).unixtime());
+    ds3231SetSqw1Hz();
+    g_app.startTimeRTC = DateTime(timebaseNow());
     g_app.modeStartRTC = g_app.startTimeRTC;
-    Serial.println(F("Clock mode serial cmds: RD | CT[=±offset] | T=YYYY-MM-DD HH:MM:SS | U=<unix_epoch>"));
+    uart.println(F("Clock mode serial cmds: " TIME_COMMANDS_HELP));
   }
+  periphRelease(PERIPH_TWI);
 
-  g_app.startMillis = millis();
-  g_app.modeStartMillis = millis();
-  g_app.modeSleepSecondsAccum = 0;
-  g_app.softSeconds = 0;
-  g_app.sysSeconds = 0;
+  g_app.startMs = deadlineNow();
+  g_app.modeStartMs = g_app.startMs;
   // Scheduler state resets on first hygroSchedulerInit
 
   interruptsInitCorePins();
@@ -194,15 +297,25 @@ void setup()
 
   enterMode(readSwitchMode());
   g_app.lastStableMode = g_app.currentMode;
-  g_app.lastModeEnterMs = millis();
   g_app.lastModeReadMs = g_app.lastModeEnterMs;
+  wakeStatsReset(); // boot time is not charged to any wake source
+
+#if !ENABLE_SERIAL_DEBUG
+  // Boot banner out; from here the USART runs only inside serial windows
+  uart.flush();
+  serialPortHold(false);
+#endif
 }
 
 void loop()
 {
+  WakeSummary wake = drainWakeEvents();
+  creditInterruptedSleep();
+  dbgLogDrain(); // debug records go out behind the work, not inline
+
   // Mode change via slide switch (debounced + re-entry guard)
   DeviceMode rawMode = readSwitchMode();
-  unsigned long nowMsLoop = millis();
+  unsigned long nowMsLoop = deadlineNow();
   if (rawMode != g_app.lastStableMode)
   {
     // provisional change; require stability for MODE_DEBOUNCE_MS
@@ -210,7 +323,7 @@ void loop()
     {
       g_app.lastStableMode = rawMode;
       g_app.lastModeReadMs = nowMsLoop;
-      g_app.switchWake = true; // treat as a switch wake event
+      wake.slide = true; // treat as a switch wake event
     }
   }
   else
@@ -218,138 +331,88 @@ void loop()
     g_app.lastModeReadMs = nowMsLoop; // stable reading refreshes timestamp
   }
 
-  if (g_app.switchWake && (g_app.lastStableMode != g_app.currentMode))
+  if (wake.slide && (g_app.lastStableMode != g_app.currentMode))
   {
     if ((nowMsLoop - g_app.lastModeEnterMs) >= MODE_REENTRY_GUARD_MS)
     {
-      DBG_PRINTLN(F("[MODE] Debounced switch change"));
-      appClearWakeFlags();
+      DBG_LOG(LOG_MODE_DEBOUNCED);
       enterMode(g_app.lastStableMode);
       // enterMode sets lastModeEnterMs; keep for guards
     }
-    else
-    {
-      // Guard period: ignore rapid flips
-      g_app.switchWake = false;
-    }
-  }
-  else if (g_app.switchWake)
-  {
-    // Switch wake but no logical mode change: clear to avoid repeated wake spam
-    g_app.switchWake = false;
+    // else guard period: ignore rapid flips
   }
 
   // Release switch PCINT mask after suppression window
-  if ((nowMsLoop - g_app.lastModeEnterMs) >= MODE_SWITCH_SUPPRESS_MS)
+  if (deadlineTake(DL_SWITCH_UNMASK))
     interruptsMaskSwitch(false);
 
   // Backlight button debounce + turn on
-  if (g_app.blButtonWake || digitalRead(BL_BUTTON_PIN) == LOW)
+  if (wake.button || !PinBlButton::read())
   {
-    unsigned long nowMs = millis();
+    unsigned long nowMs = deadlineNow();
     if (nowMs - g_app.blLastHandledMs > BL_DEBOUNCE_MS)
     {
       g_app.blLastHandledMs = nowMs;
-      g_app.blButtonWake = false;
       backlightOn();
     }
-    else
-      g_app.blButtonWake = false;
   }
+  backlightMaintain();
 
-  // Keep-awake extension if backlight or serial activity
-  if (backlightIsActive())
-    g_app.serialAwakeUntil = millis() + 1500; // slightly longer
-  if (g_app.serialWake || Serial.available())
+  // Serial activity opens / extends the keep-awake window; the RX ISR
+  // assembles lines meanwhile and timeCommandsHandle() runs each one
+  if (wake.serial || serialLineReady())
+    deadlineSet(DL_SERIAL_AWAKE, 1200);
+
+  if (g_app.currentMode == MODE_CLOCK)
   {
-    g_app.serialAwakeUntil = millis() + 1200;
-    g_app.serialWake = false;
-    drainSerial(300);
+    updateClockMode(); // no-RTC: arms DL_CLOCK_TICK for the next second
   }
-  if (g_app.currentMode == MODE_CLOCK)
+  else
   {
-    if ((long)(g_app.serialAwakeUntil - millis()) > 0)
-      timeCommandsHandle();
-    updateClockMode();
+    // Hygrometer mode: DS3231 alarms, or deadline DL_SAMPLE without an RTC
+    uint32_t nowEpoch = currentSeconds();
 
-    if ((long)(g_app.serialAwakeUntil - millis()) > 0)
+    // Stage 1: power the sensor so its settle ends on the grid second
+    if (hygroSchedulerPrewarmDue(nowEpoch))
     {
-      drainSerial(60);
-      return;
+      DBG_LOG(LOG_HYGRO_PREWARM);
+      hygroSamplerPowerUp();
+      hygroSchedulerArmSample();
     }
 
-    if (g_app.rtcAvailable)
+    // Stage 2: read on the grid second
+    bool fired = hygroSchedulerShouldFire(nowEpoch);
+
+    if (fired)
     {
-      sleepUntilTickOrSwitch();
+      hygroSchedulerAdvanceAfterFire(nowEpoch);
+
+      // Take the sample
+      updateHygroMode();
+      hygroSchedulerMarkSample(nowEpoch);
     }
-    else
+
+    // Only perform sanity adjustment AFTER we service any fired alarm.
+    hygroSchedulerSanity(nowEpoch);
+    if (hygroSchedulerFailsafeCheck(nowEpoch))
     {
-      DBG_FLUSH();
-      LowPower.powerDown(SLEEP_1S, ADC_OFF, BOD_OFF);
-      g_app.softSeconds++;
-      g_app.sysSeconds++;
+      wakeStatsSource(WS_FAILSAFE);
+      updateHygroMode();
+      hygroSchedulerMarkSample(nowEpoch);
     }
   }
-  else
+
+  // Serial keep-awake window: the USART needs its clock, so idle, not power-down
+  if (deadlineActive(DL_SERIAL_AWAKE))
   {
-    // Hygrometer mode
-    if (g_app.rtcAvailable)
-    {
-      uint32_t nowEpoch = rtc.now().unixtime();
-      bool fired = hygroSchedulerShouldFire(nowEpoch);
-
-      if (fired)
-      {
-        hygroSchedulerAdvanceAfterFire(nowEpoch);
-
-        // Take the sample
-        updateHygroMode();
-        hygroSchedulerMarkSample(nowEpoch);
-      }
-
-      // Only perform sanity adjustment AFTER we service any fired alarm.
-      hygroSchedulerSanity(nowEpoch);
-      if (hygroSchedulerFailsafeCheck(nowEpoch))
-      {
-        updateHygroMode();
-        hygroSchedulerMarkSample(nowEpoch);
-      }
-
-      // Allow serial commands during awake window
-      if ((long)(g_app.serialAwakeUntil - millis()) > 0)
-      {
-        timeCommandsHandle();
-        delay(5);
-        return;
-      }
-
-      sleepUntilAlarmOrSwitch();
-    }
-    else
-    {
-      // Fallback (no RTC): legacy WDT schedule
-      unsigned long nowMs = millis();
-      if (g_app.lastHygroUpdateMillis == 0 || (nowMs - g_app.lastHygroUpdateMillis) >= (UPDATE_INTERVAL_SEC * 1000UL))
-      {
-        updateHygroMode();
-        g_app.lastHygroUpdateMillis = millis();
-      }
-      if ((long)(g_app.serialAwakeUntil - millis()) > 0)
-      {
-        delay(5);
-        return;
-      }
-      unsigned long elapsed = (millis() - g_app.lastHygroUpdateMillis) / 1000UL;
-      uint16_t remain = (elapsed >= UPDATE_INTERVAL_SEC) ? 0 : (UPDATE_INTERVAL_SEC - elapsed);
-      if (remain > 0)
-      {
-        uint16_t slept = 0;
-        bool timedOut = sleepUntilNextOrSwitch(remain, &slept);
-        g_app.modeSleepSecondsAccum += slept;
-        g_app.sysSeconds += slept;
-        if (timedOut)
-          g_app.lastHygroUpdateMillis = 0;
-      }
-    }
+    serialWindowHold(true);
+    uint32_t t0 = wakeStatsPhaseBegin();
+    timeCommandsHandle();
+    serialIdleWait();
+    wakeStatsPhaseEnd(WP_SERIAL, t0);
+    return;
   }
+
+  serialWindowHold(false);
+  sleepUntilDeadlineOrWake();
 }
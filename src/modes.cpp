@@ -8,41 +8,64 @@
 #include "battery.h"
 #include "backlight.h"
 #include "interrupts.h"
+#include "hygro_sampler.h"
+#include "fast_gpio.h"
+#include "ds3231.h"
+#include "deadline.h"
+#include "power_profile.h"
+#include "cycle_profiler.h"
+#include "runtime_estimate.h"
 
 // Local helper: set SQW for clock mode
 static void rtc_use_sqw_for_clock()
 {
-    rtc.clearAlarm(1);
-    rtc.clearAlarm(2);
-    rtc.writeSqwPinMode(DS3231_SquareWave1Hz);
-    DBG_PRINTLN(F("[RTC] SQW=1Hz (Clock mode)"));
+    ds3231SetSqw1Hz(); // control + alarm flag clear in one burst
+    timebaseSqwCounting(true);
+    DBG_LOG(LOG_RTC_SQW);
+}
+
+// Local helper: minute clock profile, INT low once a minute via Alarm2
+static void rtc_use_minute_alarm_for_clock()
+{
+    timebaseSqwCounting(false); // per-wake DS3231 read instead
+    ds3231SetMinuteAlarm();
+    DBG_LOG(LOG_RTC_MINUTE);
+}
+
+// Seconds are worth a 1 Hz wake only while someone is looking
+static bool clockShowSeconds()
+{
+    if (!powerProfileClockSeconds())
+        return false;
+    return !CLOCK_MINUTE_PROFILE || backlightIsActive() || deadlineActive(DL_SERIAL_AWAKE);
 }
 
 DeviceMode readSwitchMode()
 {
-    return (digitalRead(MODE_PIN) == LOW) ? MODE_HYGRO : MODE_CLOCK;
+    return PinModeSwitch::read() ? MODE_CLOCK : MODE_HYGRO; // LOW = Hygro
 }
 
 void enterMode(DeviceMode m)
 {
     g_app.currentMode = m;
     interruptsMaskSwitch(true); // suppress chatter after transition
+    deadlineSet(DL_SWITCH_UNMASK, MODE_SWITCH_SUPPRESS_MS);
     if (m == MODE_HYGRO)
     {
-        DBG_PRINTLN(F("[MODE] Enter Hygrometer"));
+        DBG_LOG(LOG_MODE_HYGRO);
+        deadlineCancel(DL_CLOCK_TICK);
         if (g_app.rtcAvailable)
         {
-            g_app.modeStartRTC = rtc.now();
+            timebaseSqwCounting(false); // alarm mode: no 1 Hz edges to count
+            g_app.modeStartRTC = DateTime(timebaseNow());
             uint32_t epoch = g_app.modeStartRTC.unixtime();
             hygroSchedulerInit(epoch);
 
             interruptsEnableTick(true); // D5 as INT (falling)
             g_app.lastPinsD = PIND;
 
-            lcd.setCursor(0, 0);
-            lcdPrint16("Mode: Hygrometer");
-            lcd.setCursor(0, 1);
-            lcdPrint16("Init...");
+            lcdPrint16(0, "Mode: Hygrometer");
+            lcdPrint16(1, "Init...");
             delay(50);
 
             updateHygroMode();
@@ -50,103 +73,122 @@ void enterMode(DeviceMode m)
         }
         else
         {
-            g_app.modeStartMillis = millis();
-            g_app.lastHygroUpdateMillis = 0;
-            g_app.modeSleepSecondsAccum = 0;
+            g_app.modeStartMs = deadlineNow();
+            hygroSchedulerInit(currentSeconds()); // arms DL_SAMPLE
             interruptsEnableTick(true);
             g_app.lastPinsD = PIND;
-            lcd.setCursor(0, 0);
-            lcdPrint16("Mode: Hygrometer");
-            lcd.setCursor(0, 1);
-            lcdPrint16("Init...");
+            lcdPrint16(0, "Mode: Hygrometer");
+            lcdPrint16(1, "Init...");
             delay(50);
             updateHygroMode();
         }
     }
     else
     {
-        DBG_PRINTLN(F("[MODE] Enter Clock"));
+        DBG_LOG(LOG_MODE_CLOCK);
+        deadlineCancel(DL_SAMPLE);
+        deadlineCancel(DL_ALARM_RETRY);
+        hygroSamplerPowerDown();
         if (g_app.rtcAvailable)
             rtc_use_sqw_for_clock();
         interruptsEnableTick(true); // D5 as SQW
         g_app.lastPinsD = PIND;
-        lcd.setCursor(0, 0);
-        lcdPrint16("Mode: Clock     ");
-        lcd.setCursor(0, 1);
-        lcdPrint16(g_app.rtcAvailable ? "RTC OK" : "No RTC");
+        lcdPrint16(0, "Mode: Clock     ");
+        lcdPrint16(1, g_app.rtcAvailable ? "RTC OK" : "No RTC");
         delay(50);
-        g_app.serialAwakeUntil = millis() + 1200;
+        deadlineSet(DL_SERIAL_AWAKE, 1200);
     }
-    g_app.lastModeEnterMs = millis();
+    g_app.lastModeEnterMs = deadlineNow();
 }
 
 void updateClockMode()
 {
-    static int8_t lastSecRTC = -1;
-    static unsigned long lastSoftSec = (unsigned long)-1;
+    PROF_SCOPE(PR_UPDATE_CLOCK);
+    static uint32_t lastShownRTC = 0;
+    static uint32_t lastSoftSec = (uint32_t)-1;
+    static bool lastLit = false;
+    bool showSeconds = clockShowSeconds();
+    bool lit = backlightIsActive(); // lit: runtime estimate in place of the voltage
+    bool relit = (lit != lastLit);
+    lastLit = lit;
     if (g_app.rtcAvailable)
     {
-        DateTime now = rtc.now();
-        if (now.second() == lastSecRTC)
+        if (showSeconds != g_app.sqwCounting)
+        {
+            if (showSeconds)
+                rtc_use_sqw_for_clock();
+            else
+                rtc_use_minute_alarm_for_clock();
+            lastShownRTC = 0; // re-render in the new format
+        }
+        DateTime now(timebaseNow());
+        if (!g_app.sqwCounting && (ds3231Status() & DS3231_STATUS_A2F))
+            ds3231ClearAlarmFlags(); // release INT for the next minute
+        if (powerProfileHibernateStep())
+        {
+            batteryMaintain(now.unixtime());
+            powerProfileUpdate();
             return;
-        lastSecRTC = now.second();
-        float vbat = readBatteryVolts();
+        }
+        uint32_t shown = showSeconds ? now.unixtime() : now.unixtime() / 60UL;
+        if (shown == lastShownRTC && !relit)
+            return;
+        lastShownRTC = shown;
+        uint16_t vbatMv = batteryForDisplay(now.unixtime());
         char l1[17], l2[17];
-        buildClockLines(true, now, 0, vbat, l1, sizeof(l1), l2, sizeof(l2));
-        lcd.setCursor(0, 0);
-        lcdPrint16(l1);
-        lcd.setCursor(0, 1);
-        lcdPrint16(l2);
+        buildClockLines(true, now, 0, vbatMv, l1, sizeof(l1), l2, sizeof(l2), showSeconds);
+        if (lit)
+            buildRuntimeLine2(true, now, runtimeEstimateDays(), batteryFlag(vbatMv), l2, sizeof(l2));
+        lcdPrint16(0, l1);
+        lcdPrint16(1, l2);
     }
     else
     {
-        if (g_app.softSeconds == lastSoftSec)
+        uint32_t softSeconds = (deadlineNow() - g_app.startMs) / 1000UL;
+        uint32_t step = showSeconds ? 1UL : 60UL;
+        uint32_t shown = softSeconds - softSeconds % step;
+        deadlineSetAt(DL_CLOCK_TICK, g_app.startMs + (shown + step) * 1000UL); // wake for the next second / minute
+        if (shown == lastSoftSec && !relit)
+            return;
+        lastSoftSec = shown;
+        if (powerProfileHibernateStep())
+        {
+            batteryMaintain(currentSeconds());
+            powerProfileUpdate();
             return;
-        lastSoftSec = g_app.softSeconds;
-        float vbat = readBatteryVolts();
+        }
+        uint16_t vbatMv = batteryForDisplay(currentSeconds());
         char l1[17], l2[17];
         DateTime dummy((uint32_t)0);
-        buildClockLines(false, dummy, g_app.softSeconds, vbat, l1, sizeof(l1), l2, sizeof(l2));
-        lcd.setCursor(0, 0);
-        lcdPrint16(l1);
-        lcd.setCursor(0, 1);
-        lcdPrint16(l2);
+        buildClockLines(false, dummy, softSeconds, vbatMv, l1, sizeof(l1), l2, sizeof(l2), showSeconds);
+        if (lit)
+            buildRuntimeLine2(false, dummy, runtimeEstimateDays(), batteryFlag(vbatMv), l2, sizeof(l2));
+        lcdPrint16(0, l1);
+        lcdPrint16(1, l2);
     }
-    backlightMaintain(currentSeconds());
+    powerProfileUpdate(); // after the redraw, so a transition banner stays up
 }
 
 void updateHygroMode()
 {
-    DBG_PRINTLN(F("[HYGRO] Power DHT..."));
-    digitalWrite(DHT_PWR, HIGH);
-    delay(DHT_SETTLE_MS);
-    dht.begin();
-    float rh = dht.readHumidity();
-    float tc = dht.readTemperature();
-    if (isnan(rh) || isnan(tc))
+    PROF_SCOPE(PR_UPDATE_HYGRO);
+    if (powerProfileHibernateStep())
     {
-        DBG_PRINTLN(F("[HYGRO] Retry read"));
-        delay(400);
-        rh = dht.readHumidity();
-        tc = dht.readTemperature();
+        hygroSamplerPowerDown(); // may have been pre-warmed for this slot
+        batteryMaintain(currentSeconds());
+        powerProfileUpdate();
+        return;
     }
-    digitalWrite(DHT_PWR, LOW);
-    float vbat = readBatteryVolts();
-    DBG_PRINT(F("[HYGRO] T="));
-    DBG_PRINT(tc, 1);
-    DBG_PRINT(F("C  RH="));
-    DBG_PRINT(rh, 1);
-    DBG_PRINT(F("%  Vbat="));
-    DBG_PRINT(vbat, 3);
-    DBG_PRINTLN(F("V"));
-    char l1[17];
-    buildHygroLine1(tc, rh, l1, sizeof(l1));
-    lcd.setCursor(0, 0);
-    lcdPrint16(l1);
+    DBG_LOG(LOG_HYGRO_SAMPLE);
+    hygroSamplerStart();
+
+    // Battery + elapsed line run inside the settle window
+    uint32_t nowSec = currentSeconds();
+    uint16_t vbatMv = batteryForDisplay(nowSec);
     char ebuf[12];
     if (g_app.rtcAvailable)
     {
-        uint32_t nowEpoch = rtc.now().unixtime();
+        uint32_t nowEpoch = nowSec;
         uint32_t base = hygroSchedulerBaseEpoch();
         uint32_t secs = (nowEpoch > base) ? (nowEpoch - base) : 0;
         TimeSpan el(secs);
@@ -154,27 +196,31 @@ void updateHygroMode()
     }
     else
     {
-        unsigned long awakeMs = millis() - g_app.modeStartMillis;
-        unsigned long elapsedMs = awakeMs + (g_app.modeSleepSecondsAccum * 1000UL);
-        formatElapsedMillis(elapsedMs, ebuf, sizeof(ebuf));
+        formatElapsedMillis(deadlineNow() - g_app.modeStartMs, ebuf, sizeof(ebuf));
     }
     char l2[17];
     char rtcFlag = g_app.rtcAvailable ? 'R' : 'T';
-    char batFlag = batteryFlag(vbat);
-    buildHygroLine2(ebuf, rtcFlag, vbat, batFlag, l2, sizeof(l2));
-    lcd.setCursor(0, 1);
-    lcdPrint16(l2);
-    DBG_PRINT(F("[HYGRO] LCD L2: "));
-    DBG_PRINTLN(l2);
-    DBG_PRINT(F("[HYGRO] Elapsed="));
-    DBG_PRINT(ebuf);
-    DBG_PRINT('(');
-    DBG_PRINT(rtcFlag);
-    DBG_PRINT(F(")  V="));
-    int elen = strlen(ebuf);
-    DBG_PRINT(vbat, (elen <= 7) ? 2 : ((elen == 8) ? 1 : 0));
-    DBG_PRINT(F("V  Flag="));
-    DBG_PRINT(batFlag);
-    DBG_PRINTLN();
-    backlightMaintain(currentSeconds());
+    char batFlag = batteryFlag(vbatMv);
+    buildHygroLine2(ebuf, rtcFlag, vbatMv, batFlag, l2, sizeof(l2));
+    lcdPrint16(1, l2);
+
+    // Sleep out the rest of the settle (and retry gap), then read
+    hygroSamplerRun();
+    int16_t rh10 = hygroSamplerHumidity();
+    int16_t tc10 = hygroSamplerTemperature();
+    hygroSchedulerNoteReading(tc10, rh10); // may change the interval and so the power policy
+    if (!hygroSchedulerKeepSensorPowered())
+        hygroSamplerPowerDown();
+
+    DBG_LOG(LOG_HYGRO_READING, tc10, rh10, vbatMv);
+    char l1[17];
+    buildHygroLine1(tc10, rh10, l1, sizeof(l1));
+    lcdPrint16(0, l1);
+    DBG_LOG(LOG_HYGRO_LCD_L2, (const char *)l2);
+    DBG_LOG(LOG_HYGRO_ELAPSED, (const char *)ebuf, rtcFlag, vbatMv, batFlag);
+    static uint32_t lastBusBytes = 0;
+    uint32_t busBytes = ds3231BusBytes();
+    DBG_LOG(LOG_I2C_BYTES, (uint32_t)(busBytes - lastBusBytes));
+    lastBusBytes = busBytes;
+    powerProfileUpdate(); // after the redraw, so a transition banner stays up
 }
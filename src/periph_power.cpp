@@ -0,0 +1,32 @@
+#include "periph_power.h"
+#include "pins.h"
+
+static uint8_t g_refs[8]; // per PRR bit
+
+void periphInit()
+{
+    ADCSRA &= ~_BV(ADEN); // the core's init() enables the ADC; it must be off before gating
+    ACSR = _BV(ACD);      // analog comparator unused
+    // VBAT is analog only: its digital input buffer would draw current at mid-rail
+    DIDR0 |= _BV((VBAT_PIN - A0) & 0x07);
+    PRR = (uint8_t)(_BV(PRTWI) | _BV(PRTIM2) | _BV(PRTIM1) | _BV(PRSPI) | _BV(PRUSART0) | _BV(PRADC));
+    memset(g_refs, 0, sizeof(g_refs));
+}
+
+bool periphAcquire(Periph p)
+{
+    if (g_refs[p]++ != 0)
+        return false;
+    bool wasGated = PRR & _BV(p);
+    PRR &= (uint8_t)~_BV(p);
+    return wasGated;
+}
+
+void periphRelease(Periph p)
+{
+    if (g_refs[p] == 0 || --g_refs[p] != 0)
+        return;
+    PRR |= _BV(p);
+}
+
+bool periphPowered(Periph p) { return !(PRR & _BV(p)); }
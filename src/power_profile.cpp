@@ -0,0 +1,83 @@
+#include "power_profile.h"
+#include "battery.h"
+#include "display_utils.h"
+#include "globals.h"
+#include "backlight.h"
+#include "alarm_scheduler.h"
+
+static PowerProfile g_profile = PP_NORMAL;
+static bool g_lcdOff = false;
+
+// Highest profile whose entry threshold mv is below
+static PowerProfile profileFor(uint16_t mv)
+{
+    if (mv < VBAT_HIBERNATE_MV)
+        return PP_HIBERNATE;
+    if (mv < VBAT_LOW_MV)
+        return PP_CRITICAL;
+    if (mv < VBAT_MED_MV)
+        return PP_LOW;
+    return PP_NORMAL;
+}
+
+static void announce(PowerProfile p)
+{
+    static const char *const kNames[] = {"Power: normal", "Power save: low", "Power save: crit", "LowBatt: LCD off"};
+    lcdPrint16(0, kNames[p]);
+    DBG_LOG(LOG_PWR_PROFILE, kNames[p]);
+}
+
+void powerProfileUpdate()
+{
+    uint16_t mv = batteryMillivolts();
+    if (mv == 0)
+        return; // not measured yet
+    PowerProfile worse = profileFor(mv);
+    PowerProfile better = profileFor(mv > POWER_PROFILE_HYST_MV ? mv - POWER_PROFILE_HYST_MV : 0);
+    PowerProfile next = g_profile;
+    if (worse > g_profile)
+        next = worse; // degrade at once
+    else if (better < g_profile)
+        next = better; // recover only with POWER_PROFILE_HYST_MV margin
+    if (next == g_profile)
+        return;
+    if (g_lcdOff)
+    {
+        lcd.display();
+        g_lcdOff = false;
+    }
+    g_profile = next;
+    announce(next); // HIBERNATE: shown until the next update turns the LCD off
+    hygroSchedulerProfileChanged(); // new interval floor: the armed alarm is on the old grid
+}
+
+PowerProfile powerProfile() { return g_profile; }
+
+uint32_t powerProfileBacklightSec()
+{
+    return (g_profile == PP_NORMAL) ? BACKLIGHT_DURATION_SEC : PP_LOW_BACKLIGHT_SEC;
+}
+
+uint32_t powerProfileMinIntervalSec()
+{
+    if (g_profile == PP_NORMAL)
+        return 0;
+    return (g_profile == PP_LOW) ? PP_LOW_MIN_INTERVAL_SEC : UPDATE_INTERVAL_MAX_SEC;
+}
+
+bool powerProfileClockSeconds() { return g_profile == PP_NORMAL; }
+
+bool powerProfileHibernating() { return g_profile == PP_HIBERNATE; }
+
+bool powerProfileHibernateStep()
+{
+    if (g_profile != PP_HIBERNATE)
+        return false;
+    if (!g_lcdOff)
+    {
+        backlightOff();
+        lcd.noDisplay();
+        g_lcdOff = true;
+    }
+    return true;
+}
@@ -0,0 +1,74 @@
+#include "ram_monitor.h"
+
+#if ENABLE_RAM_MONITOR
+
+#define RAM_STR2(x) #x
+#define RAM_STR(x) RAM_STR2(x)
+
+extern uint8_t __data_start;
+extern uint8_t __heap_start;                  // end of .bss
+extern char *__brkval __attribute__((weak)); // only linked when malloc() is
+
+// From .init3: SP and r1 are set up (.init2) and nothing is on the stack
+// yet. .data/.bss are filled later (.init4) and lie below the painted
+// range anyway. Plain asm: a naked function has no frame for C locals.
+extern "C" void ramPaint() __attribute__((naked, used, section(".init3")));
+extern "C" void ramPaint()
+{
+    __asm__ __volatile__(
+        "    ldi r30, lo8(__heap_start)\n"
+        "    ldi r31, hi8(__heap_start)\n"
+        "    ldi r24, " RAM_STR(RAM_PAINT) "\n"
+        "    ldi r25, hi8(__stack)\n"
+        "    rjmp 2f\n"
+        "1:  st Z+, r24\n"
+        "2:  cpi r30, lo8(__stack)\n"
+        "    cpc r31, r25\n"
+        "    brlo 1b\n"
+        "    breq 1b\n" ::);
+}
+
+static const uint8_t *stackPtr() { return (const uint8_t *)(uintptr_t)SP; } // next free stack byte
+
+static const uint8_t *heapTop()
+{
+    if (&__brkval && __brkval)
+        return (const uint8_t *)__brkval;
+    return &__heap_start;
+}
+
+uint16_t ramStaticBytes() { return (uint16_t)(&__heap_start - &__data_start); }
+
+uint16_t ramFreeNow() { return (uint16_t)(stackPtr() - heapTop()); }
+
+uint16_t ramFreeMin()
+{
+    const uint8_t *p = heapTop();
+    const uint8_t *sp = stackPtr();
+    uint16_t n = 0;
+    while (p + n < sp && p[n] == RAM_PAINT)
+        n++;
+    return n;
+}
+
+void ramDump(Print &out)
+{
+    uint16_t freeMin = ramFreeMin();
+    const uint8_t *ramEnd = (const uint8_t *)(uintptr_t)(RAMEND + 1);
+    out.print(F("[RM] ram="));
+    out.print((uint16_t)(ramEnd - &__data_start));
+    out.print(F(" static="));
+    out.print(ramStaticBytes());
+    out.print(F(" heap="));
+    out.println((uint16_t)(heapTop() - &__heap_start));
+    out.print(F("[RM] stack_now="));
+    out.print((uint16_t)(ramEnd - stackPtr() - 1));
+    out.print(F(" stack_max="));
+    out.print((uint16_t)(ramEnd - (heapTop() + freeMin)));
+    out.print(F(" free_now="));
+    out.print(ramFreeNow());
+    out.print(F(" free_min="));
+    out.println(freeMin);
+}
+
+#endif
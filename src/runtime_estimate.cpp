@@ -0,0 +1,279 @@
+#include "runtime_estimate.h"
+#include "backlight.h"
+#include "cpu_clock.h"
+#include "deadline.h"
+#include "debug.h"
+#include "hygro_sampler.h"
+
+// Li-ion resting voltage to usable charge (per mille), empty at hibernate
+struct SocPoint
+{
+    uint16_t mv;
+    uint16_t pm;
+};
+static const SocPoint kSoc[] PROGMEM = {
+    {4150, 1000}, {4050, 900}, {3950, 780}, {3850, 620}, {3780, 480},
+    {3720, 340}, {3670, 220}, {3600, 120}, {3500, 50}, {VBAT_HIBERNATE_MV, 0}};
+
+enum Load : uint8_t
+{
+    LD_BASE = 0, // always drawn
+    LD_AWAKE,
+    LD_DHT,
+    LD_BACKLIGHT,
+    LD_COUNT
+};
+static const char kLoadNames[LD_COUNT][6] PROGMEM = {"base", "awake", "dht", "bl"};
+
+struct TrendPoint
+{
+    uint16_t hour; // estimator hours (wraps)
+    uint16_t mv;
+};
+
+#define TREND_RESET_MV 100 // a rise this large means a charged / swapped battery
+
+// Open duty-cycle window: counters at its start
+static bool g_open = false;
+static uint32_t g_winMs = 0;
+static uint32_t g_winAwakeUs = 0;
+static uint32_t g_winLitMs = 0;
+static uint32_t g_winDhtMs = 0;
+static uint16_t g_winUps = 0;
+
+static uint32_t g_minutes = 0; // closed windows, summed
+static uint32_t g_carryMs = 0; // sub-minute remainder
+static uint32_t g_chargeUaMin = 0; // model charge over g_spanMin, decaying
+static uint32_t g_spanMin = 0;
+static uint32_t g_avgUa = 0;       // g_chargeUaMin / g_spanMin (0 = no window yet)
+static uint16_t g_loadUa[LD_COUNT];
+
+static TrendPoint g_trend[EST_TREND_POINTS];
+static uint8_t g_trendN = 0;
+static uint8_t g_trendHead = 0; // next slot
+static uint32_t g_trendMin = 0; // g_minutes of the newest point
+
+static uint16_t g_mv = 0;
+static uint16_t g_socPm = 0;
+static int32_t g_slopeMvDay = 0;
+static uint16_t g_modelDays = RUNTIME_UNKNOWN;
+static uint16_t g_trendDays = RUNTIME_UNKNOWN;
+static uint16_t g_days = RUNTIME_UNKNOWN;
+
+static uint16_t socPermille(uint16_t mv)
+{
+    if (mv >= pgm_read_word(&kSoc[0].mv))
+        return 1000;
+    for (uint8_t i = 1; i < sizeof(kSoc) / sizeof(kSoc[0]); i++)
+    {
+        uint16_t lo = pgm_read_word(&kSoc[i].mv);
+        if (mv < lo)
+            continue;
+        uint16_t hi = pgm_read_word(&kSoc[i - 1].mv);
+        uint16_t pLo = pgm_read_word(&kSoc[i].pm);
+        uint16_t pHi = pgm_read_word(&kSoc[i - 1].pm);
+        return pLo + (uint16_t)((uint32_t)(mv - lo) * (pHi - pLo) / (hi - lo));
+    }
+    return 0;
+}
+
+// part / whole in Q16, saturating, without a 64-bit divide
+static uint16_t shareQ16(uint32_t part, uint32_t whole)
+{
+    if (part >= whole)
+        return 0xFFFF;
+    while (part >= 0x10000UL)
+    {
+        part >>= 1;
+        whole >>= 1;
+    }
+    uint32_t q = (part << 16) / whole;
+    return (q > 0xFFFFUL) ? 0xFFFF : (uint16_t)q;
+}
+
+static uint16_t loadUa(uint32_t ua, uint32_t ms, uint32_t totalMs)
+{
+    return (uint16_t)((ua * shareQ16(ms, totalMs)) >> 16);
+}
+
+static uint16_t capDays(uint32_t d) { return (d > RUNTIME_MAX_DAYS) ? RUNTIME_MAX_DAYS : (uint16_t)d; }
+
+static void openWindow()
+{
+    g_winMs = deadlineNow();
+    g_winAwakeUs = cpuClockMicros();
+    g_winLitMs = backlightOnMs();
+    g_winDhtMs = hygroSamplerPoweredMs();
+    g_winUps = hygroSamplerPowerUps();
+    g_open = true;
+}
+
+// Fold the window's duty cycle into the model current and start the next
+// one; false (window kept open) while it is too short to mean anything.
+static bool closeWindow()
+{
+    uint32_t totalMs = deadlineNow() - g_winMs;
+    if (totalMs < BATTERY_REFRESH_SEC * 500UL)
+        return false;
+    // Awake time must stay under ~71 min per window (micros() wrap): the
+    // refresh cadence keeps windows far shorter than that.
+    uint32_t awakeMs = (cpuClockMicros() - g_winAwakeUs) / 1000UL;
+    uint32_t litMs = backlightOnMs() - g_winLitMs;
+    uint32_t dhtMs = hygroSamplerPoweredMs() - g_winDhtMs;
+    uint32_t settleMs = (uint32_t)(uint16_t)(hygroSamplerPowerUps() - g_winUps) * DHT_SETTLE_MS;
+
+    g_loadUa[LD_BASE] = EST_I_SLEEP_UA;
+    g_loadUa[LD_AWAKE] = loadUa(EST_I_AWAKE_UA, awakeMs, totalMs);
+    g_loadUa[LD_DHT] = loadUa(DHT_STANDBY_UA, dhtMs, totalMs) +
+                       loadUa(DHT_SETTLE_UA - DHT_STANDBY_UA, settleMs, totalMs);
+    g_loadUa[LD_BACKLIGHT] = loadUa(EST_I_BACKLIGHT_UA, litMs, totalMs);
+    uint32_t ua = 0;
+    for (uint8_t i = 0; i < LD_COUNT; i++)
+        ua += g_loadUa[i];
+
+    // Charge-weighted average, halved past two time constants so older
+    // duty cycles fade out (ua * 2 * EST_AVG_TAU_MIN stays inside 32 bits)
+    uint32_t winMin = totalMs / 60000UL;
+    g_chargeUaMin += ua * winMin;
+    g_spanMin += winMin;
+    while (g_spanMin > 2 * EST_AVG_TAU_MIN)
+    {
+        g_chargeUaMin >>= 1;
+        g_spanMin >>= 1;
+    }
+    g_avgUa = g_chargeUaMin / g_spanMin;
+
+    g_carryMs += totalMs;
+    g_minutes += g_carryMs / 60000UL;
+    g_carryMs %= 60000UL;
+    openWindow();
+    return true;
+}
+
+static void trendPush(uint16_t mv)
+{
+    if (g_trendN)
+    {
+        uint8_t newest = (g_trendHead + EST_TREND_POINTS - 1) % EST_TREND_POINTS;
+        if (mv > g_trend[newest].mv + TREND_RESET_MV)
+            g_trendN = 0; // history no longer describes this charge
+        else if (g_minutes - g_trendMin < EST_TREND_STEP_MIN)
+            return;
+    }
+    g_trendMin = g_minutes;
+    g_trend[g_trendHead].hour = (uint16_t)(g_minutes / 60UL);
+    g_trend[g_trendHead].mv = mv;
+    g_trendHead = (g_trendHead + 1) % EST_TREND_POINTS;
+    if (g_trendN < EST_TREND_POINTS)
+        g_trendN++;
+}
+
+// Least-squares voltage slope over the ring as num / den mV per hour
+static bool trendSlope(int32_t *num, int32_t *den)
+{
+    if (g_trendN < EST_TREND_MIN_POINTS)
+        return false;
+    uint8_t first = (g_trendHead + EST_TREND_POINTS - g_trendN) % EST_TREND_POINTS;
+    // Offsets from the oldest point keep every sum well inside 32 bits
+    int32_t sx = 0, sy = 0, sxx = 0, sxy = 0;
+    for (uint8_t i = 0; i < g_trendN; i++)
+    {
+        const TrendPoint &p = g_trend[(first + i) % EST_TREND_POINTS];
+        int32_t x = (uint16_t)(p.hour - g_trend[first].hour);
+        int32_t y = (int32_t)p.mv - g_trend[first].mv;
+        sx += x;
+        sy += y;
+        sxx += x * x;
+        sxy += x * y;
+    }
+    *num = g_trendN * sxy - sx * sy;
+    *den = g_trendN * sxx - sx * sx;
+    return *den > 0;
+}
+
+static void recompute(uint16_t mv)
+{
+    g_mv = mv;
+    g_socPm = socPermille(mv);
+    if (mv <= VBAT_HIBERNATE_MV)
+    {
+        g_modelDays = g_trendDays = g_days = 0;
+        return;
+    }
+
+    g_modelDays = RUNTIME_UNKNOWN;
+    if (g_avgUa)
+        g_modelDays = capDays((uint32_t)EST_BATTERY_MAH * g_socPm / g_avgUa / 24UL); // uAh / uA = h
+
+    g_trendDays = RUNTIME_UNKNOWN;
+    g_slopeMvDay = 0;
+    int32_t num, den;
+    if (trendSlope(&num, &den))
+    {
+        g_slopeMvDay = num * 24 / den;
+        if (num < 0)
+            g_trendDays = capDays((uint32_t)(mv - VBAT_HIBERNATE_MV) * (uint32_t)den / (uint32_t)(-num) / 24UL);
+    }
+
+    if (g_trendDays == RUNTIME_UNKNOWN)
+        g_days = g_modelDays;
+    else if (g_modelDays == RUNTIME_UNKNOWN)
+        g_days = g_trendDays;
+    else
+    {
+        // The trend earns weight with history, up to half at a full ring
+        const uint32_t full = 2UL * EST_TREND_POINTS;
+        g_days = (uint16_t)(((uint32_t)g_modelDays * (full - g_trendN) + (uint32_t)g_trendDays * g_trendN) / full);
+    }
+}
+
+void runtimeEstimateUpdate(uint16_t mv)
+{
+    if (!g_open)
+    {
+        openWindow();
+        trendPush(mv);
+    }
+    else if (closeWindow())
+        trendPush(mv);
+    recompute(mv);
+    DBG_LOG(LOG_RUNTIME, g_days, g_modelDays, g_trendDays, (uint16_t)g_avgUa);
+}
+
+uint16_t runtimeEstimateDays() { return g_days; }
+
+static void printDays(Print &out, const __FlashStringHelper *label, uint16_t d)
+{
+    out.print(label);
+    if (d == RUNTIME_UNKNOWN)
+        out.print('-');
+    else
+        out.print(d);
+}
+
+void runtimeEstimateDump(Print &out)
+{
+    printDays(out, F("[RT] days="), g_days);
+    printDays(out, F(" model="), g_modelDays);
+    printDays(out, F(" trend="), g_trendDays);
+    out.println();
+    out.print(F("[RT] avg_ua="));
+    out.print(g_avgUa);
+    out.print(F(" last"));
+    for (uint8_t i = 0; i < LD_COUNT; i++)
+    {
+        out.print(' ');
+        out.print((const __FlashStringHelper *)kLoadNames[i]);
+        out.print('=');
+        out.print(g_loadUa[i]);
+    }
+    out.println();
+    out.print(F("[RT] mv="));
+    out.print(g_mv);
+    out.print(F(" soc_pm="));
+    out.print(g_socPm);
+    out.print(F(" slope_mv_day="));
+    out.print(g_slopeMvDay);
+    out.print(F(" points="));
+    out.println(g_trendN);
+}
@@ -0,0 +1,187 @@
+#include "serial_port.h"
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+#include "periph_power.h"
+
+SerialPort uart;
+
+// ---- TX ring (consumer: UDRE ISR) ----
+static uint8_t g_tx[SERIAL_TX_BUF];
+static volatile uint8_t g_txHead = 0; // next write (main)
+static volatile uint8_t g_txTail = 0; // next send (ISR)
+static volatile bool g_txWritten = false;
+static uint16_t g_ubrr = 0;
+
+// ---- RX line slots (producer: RX ISR) ----
+static char g_lines[SERIAL_LINE_SLOTS][SERIAL_LINE_MAX];
+static volatile uint8_t g_lineCount = 0; // completed, not yet released
+static uint8_t g_lineHead = 0;           // oldest completed (main only)
+static uint8_t g_lineTail = 0;           // slot being assembled (ISR only)
+static volatile uint16_t g_linesDropped = 0;
+
+// Assembly state (ISR only)
+static uint8_t g_len = 0;     // bytes stored in the current line
+static uint8_t g_end = 0;     // length up to the last non-space (trailing trim)
+static bool g_inToken = true; // still inside the command token (upper-cased)
+static bool g_overflow = false;
+
+static void configure()
+{
+    UCSR0A = _BV(U2X0);
+    UBRR0H = (uint8_t)(g_ubrr >> 8);
+    UBRR0L = (uint8_t)g_ubrr;
+    UCSR0C = _BV(UCSZ01) | _BV(UCSZ00); // 8N1
+    UCSR0B = _BV(RXEN0) | _BV(TXEN0) | _BV(RXCIE0);
+}
+
+void SerialPort::begin(unsigned long baud)
+{
+    // Double-speed mode as the Arduino core does: 115200 @ 16 MHz -> UBRR 16 (+2.1 %)
+    g_ubrr = (uint16_t)((F_CPU / 4 / baud - 1) / 2);
+    serialPortHold(true);
+}
+
+void serialPortHold(bool hold)
+{
+    if (!hold)
+    {
+        if (g_ubrr)
+            periphRelease(PERIPH_USART0);
+        return;
+    }
+    if (!g_ubrr)
+        return; // never begun (serial disabled in config)
+    if (periphAcquire(PERIPH_USART0))
+    {
+        // Anything queued while gated never went out
+        g_txTail = g_txHead;
+        configure();
+    }
+}
+
+static inline void txSendNext()
+{
+    uint8_t t = g_txTail;
+    UDR0 = g_tx[t];
+    g_txTail = (uint8_t)((t + 1) & (SERIAL_TX_BUF - 1));
+    UCSR0A = (uint8_t)((UCSR0A & _BV(U2X0)) | _BV(TXC0)); // clear TXC for flush()
+    if (g_txTail == g_txHead)
+        UCSR0B &= ~_BV(UDRIE0);
+}
+
+size_t SerialPort::write(uint8_t value)
+{
+    if (!periphPowered(PERIPH_USART0))
+        return 0; // gated: UDR0 writes are ignored and the ring would never drain
+    g_txWritten = true;
+    // Idle line: skip the ring
+    if (g_txHead == g_txTail && (UCSR0A & _BV(UDRE0)))
+    {
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+        {
+            UDR0 = value;
+            UCSR0A = (uint8_t)((UCSR0A & _BV(U2X0)) | _BV(TXC0));
+        }
+        return 1;
+    }
+    uint8_t next = (uint8_t)((g_txHead + 1) & (SERIAL_TX_BUF - 1));
+    while (next == g_txTail)
+    {
+        // Ring full: with interrupts off nobody drains it, so do it here
+        if (!(SREG & _BV(SREG_I)) && (UCSR0A & _BV(UDRE0)))
+            txSendNext();
+    }
+    g_tx[g_txHead] = value;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        g_txHead = next;
+        UCSR0B |= _BV(UDRIE0);
+    }
+    return 1;
+}
+
+int SerialPort::availableForWrite()
+{
+    return (uint8_t)((g_txTail - g_txHead - 1) & (SERIAL_TX_BUF - 1));
+}
+
+void SerialPort::flush()
+{
+    if (!g_txWritten || !periphPowered(PERIPH_USART0))
+        return;
+    while ((UCSR0B & _BV(UDRIE0)) || !(UCSR0A & _BV(TXC0)))
+    {
+        if (!(SREG & _BV(SREG_I)) && (UCSR0B & _BV(UDRIE0)) && (UCSR0A & _BV(UDRE0)))
+            txSendNext();
+    }
+}
+
+ISR(USART_UDRE_vect)
+{
+    txSendNext();
+}
+
+static void lineReset()
+{
+    g_len = 0;
+    g_end = 0;
+    g_inToken = true;
+    g_overflow = false;
+}
+
+ISR(USART_RX_vect)
+{
+    bool frameError = UCSR0A & _BV(FE0); // typically the byte that woke us from power-down
+    char c = (char)UDR0;
+    if (frameError)
+        return;
+    if (c == '\r' || c == '\n')
+    {
+        if (g_overflow)
+            g_linesDropped++;
+        else if (g_end > 0)
+        {
+            g_lines[g_lineTail][g_end] = 0;
+            g_lineTail = (uint8_t)((g_lineTail + 1) % SERIAL_LINE_SLOTS);
+            g_lineCount++;
+        }
+        lineReset();
+        return;
+    }
+    if (g_overflow || (g_len == 0 && c == ' '))
+        return;
+    if (g_lineCount >= SERIAL_LINE_SLOTS || g_len >= SERIAL_LINE_MAX - 1)
+    {
+        g_overflow = true; // whole line is dropped and counted at its end
+        return;
+    }
+    if (c == ' ' || c == '=')
+        g_inToken = false;
+    else if (g_inToken && c >= 'a' && c <= 'z')
+        c = (char)(c - 'a' + 'A');
+    g_lines[g_lineTail][g_len++] = c;
+    if (c != ' ')
+        g_end = g_len;
+}
+
+bool serialLineReady() { return g_lineCount > 0; }
+
+const char *serialLinePeek()
+{
+    return g_lineCount ? g_lines[g_lineHead] : nullptr;
+}
+
+void serialLineRelease()
+{
+    if (!g_lineCount)
+        return;
+    g_lineHead = (uint8_t)((g_lineHead + 1) % SERIAL_LINE_SLOTS);
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { g_lineCount--; }
+}
+
+uint16_t serialLinesDropped()
+{
+    uint16_t n;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { n = g_linesDropped; }
+    return n;
+}
@@ -0,0 +1,114 @@
+#include "sleep_utils.h"
+#include <LowPower.h>
+#include <avr/sleep.h>
+#include <avr/wdt.h>
+#include "app_state.h"
+#include "timebase.h"
+#include "serial_port.h"
+#include "event_queue.h"
+#include "debug_log.h"
+
+struct SleepSlice
+{
+    uint16_t ms;
+    period_t period;
+};
+
+static const SleepSlice kSlices[] = {
+    {8000, SLEEP_8S},
+    {4000, SLEEP_4S},
+    {2000, SLEEP_2S},
+    {1000, SLEEP_1S},
+    {500, SLEEP_500MS},
+    {250, SLEEP_250MS},
+    {120, SLEEP_120MS},
+    {60, SLEEP_60MS},
+    {30, SLEEP_30MS},
+    {15, SLEEP_15MS},
+};
+
+
+// Whether the WDT ended the last slice. LowPower's WDT_vect disables the
+// watchdog, so WDIE still set means another interrupt woke us first; that
+// includes pin changes that queue no event (SQW falling edge while counting,
+// button release). The pending timeout is stopped so it cannot wake a later
+// sleep.
+static bool sliceCompleted()
+{
+    if (!(WDTCSR & _BV(WDIE)))
+        return true;
+    wdt_disable();
+    return false;
+}
+
+// Largest slice that fits; a sub-15 ms request rounds up to one 15 ms slice
+static const SleepSlice *sliceFor(uint32_t ms)
+{
+    for (uint8_t i = 0; i < sizeof(kSlices) / sizeof(kSlices[0]); ++i)
+    {
+        if (kSlices[i].ms <= ms)
+            return &kSlices[i];
+    }
+    return &kSlices[sizeof(kSlices) / sizeof(kSlices[0]) - 1];
+}
+
+uint16_t sleepPowerDownMs(uint16_t ms)
+{
+    uint16_t slept = 0;
+    timebaseInvalidate(); // millis() extrapolation breaks across power-down
+    while (slept < ms)
+    {
+        uint16_t remain = ms - slept;
+        const SleepSlice *s = sliceFor(remain);
+        dbgLogSettle(); // power-down stops the USART mid-byte
+        LowPower.powerDown(s->period, ADC_ON, BOD_OFF); // ADC already disabled + gated (periph_power)
+        if (!sliceCompleted())
+            continue; // woken early by a pin change; slice length unknown
+        slept = (s->ms >= remain) ? ms : (uint16_t)(slept + s->ms);
+    }
+    return slept;
+}
+
+uint16_t sleepPowerDownSliceMs(uint32_t maxMs)
+{
+    timebaseInvalidate();
+    const SleepSlice *s = sliceFor(maxMs);
+    dbgLogSettle();
+    LowPower.powerDown(s->period, ADC_ON, BOD_OFF); // ADC already disabled + gated (periph_power)
+    return sliceCompleted() ? s->ms : 0;
+}
+
+void sleepPowerDownUntilWake()
+{
+    timebaseInvalidate();
+    dbgLogSettle();
+    set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+    for (;;)
+    {
+        noInterrupts();
+        if (eventQueuePending())
+            break;
+        sleep_enable();
+        sleep_bod_disable();
+        interrupts(); // sei + sleep execute back to back
+        sleep_cpu();
+        sleep_disable();
+    }
+    interrupts();
+}
+
+void sleepIdleUntilLine(uint16_t ms)
+{
+    // Plain idle: PRR already gates what is unused (periph_power), and
+    // LowPower.idle() would re-enable every module it was told to turn off
+    set_sleep_mode(SLEEP_MODE_IDLE);
+    unsigned long t0 = millis();
+    while (!serialLineReady() && (millis() - t0) < ms && !eventQueuePending())
+    {
+        dbgLogDrain();
+        // Timer0 wakes every ~1 ms, which also bounds the check/sleep race
+        sleep_enable();
+        sleep_cpu();
+        sleep_disable();
+    }
+}
@@ -1,7 +1,14 @@
 #include "time_commands.h"
 #include <RTClib.h>
 #include <ctype.h>
+#include "alarm_scheduler.h"
+#include "cycle_profiler.h"
 #include "debug.h"
+#include "ds3231.h"
+#include "ram_monitor.h"
+#include "runtime_estimate.h"
+#include "serial_port.h"
+#include "wake_stats.h"
 
 extern RTC_DS3231 rtc; // from main.cpp
 #include "app_state.h"
@@ -11,12 +18,14 @@ static void printRTC()
 {
     if (!g_app.rtcAvailable)
     {
-        Serial.println(F("[RTC] not available"));
+        uart.println(F("[RTC] not available"));
         return;
     }
-    DateTime now = rtc.now();
-    Serial.print(F("[RTC] "));
-    Serial.println(now.timestamp(DateTime::TIMESTAMP_FULL));
+    uint32_t epoch = 0;
+    ds3231ReadTimeStatus(&epoch);
+    DateTime now(epoch);
+    uart.print(F("[RTC] "));
+    uart.println(now.timestamp(DateTime::TIMESTAMP_FULL));
 }
 
 static bool parseYMDHMS(const char *s, DateTime &out)
@@ -105,11 +114,61 @@ static bool parseOffsetSeconds(const char *s, long &outSecs)
     }
 }
 
+// After a time write: drop the local epoch and put INT back on what the
+// current mode expects (the sample grid moved with the clock)
+static void timeWasSet(uint32_t epoch)
+{
+    timebaseResync();
+    if (g_app.currentMode != MODE_CLOCK)
+        hygroSchedulerInit(epoch);
+    else if (g_app.sqwCounting)
+        ds3231SetSqw1Hz();
+    else
+        ds3231SetMinuteAlarm();
+}
+
 static void processTimeCommand(const char *line)
 {
+    // Diagnostics (wake stats, runtime, profiler, RAM) do not need the RTC
+    if (line && !strcmp(line, "ST"))
+    {
+        wakeStatsDump(uart);
+        return;
+    }
+    if (line && !strcmp(line, "ST=0"))
+    {
+        wakeStatsReset();
+        uart.println(F("[ST] cleared"));
+        return;
+    }
+    if (line && !strcmp(line, "RT"))
+    {
+        runtimeEstimateDump(uart);
+        return;
+    }
+#if ENABLE_CYCLE_PROFILER
+    if (line && !strcmp(line, "PF"))
+    {
+        profDump(uart);
+        return;
+    }
+    if (line && !strcmp(line, "PF=0"))
+    {
+        profReset();
+        uart.println(F("[PF] cleared"));
+        return;
+    }
+#endif
+#if ENABLE_RAM_MONITOR
+    if (line && !strcmp(line, "RM"))
+    {
+        ramDump(uart);
+        return;
+    }
+#endif
     if (!line || !g_app.rtcAvailable)
     {
-        Serial.println(F("[RTC] not available or bad command"));
+        uart.println(F("[RTC] not available or bad command"));
         return;
     }
     if (!strcmp(line, "R") || !strcmp(line, "D") || !strcmp(line, "RD"))
@@ -133,22 +192,22 @@ static void processTimeCommand(const char *line)
         bool hasOffset = (*p != '\0');
         if (hasOffset && !parseOffsetSeconds(p, off))
         {
-            Serial.println(F("[ERR] CT offset: seconds or HH:MM:SS"));
+            uart.println(F("[ERR] CT offset: seconds or HH:MM:SS"));
             return;
         }
         long newEpoch = (long)base.unixtime() + off;
         if (newEpoch < 0)
             newEpoch = 0;
-        rtc.adjust(DateTime((uint32_t)newEpoch));
-        rtc.writeSqwPinMode(DS3231_SquareWave1Hz);
-        Serial.print(F("[RTC] set to compile time"));
+        ds3231SetTime((uint32_t)newEpoch);
+        timeWasSet((uint32_t)newEpoch);
+        uart.print(F("[RTC] set to compile time"));
         if (hasOffset)
         {
-            Serial.print(F(" + "));
-            Serial.print(off);
-            Serial.print(F("s"));
+            uart.print(F(" + "));
+            uart.print(off);
+            uart.print(F("s"));
         }
-        Serial.println();
+        uart.println();
         printRTC();
         return;
     }
@@ -160,13 +219,13 @@ static void processTimeCommand(const char *line)
             s++;
         if (parseYMDHMS(s, dt))
         {
-            rtc.adjust(dt);
-            rtc.writeSqwPinMode(DS3231_SquareWave1Hz);
-            Serial.println(F("[RTC] set to given timestamp"));
+            ds3231SetTime(dt.unixtime());
+            timeWasSet(dt.unixtime());
+            uart.println(F("[RTC] set to given timestamp"));
             printRTC();
         }
         else
-            Serial.println(F("[ERR] Use T=YYYY-MM-DD HH:MM:SS"));
+            uart.println(F("[ERR] Use T=YYYY-MM-DD HH:MM:SS"));
         return;
     }
     if (!strncmp(line, "U=", 2))
@@ -175,41 +234,31 @@ static void processTimeCommand(const char *line)
         while (*s == ' ')
             s++;
         unsigned long epoch = strtoul(s, nullptr, 10);
-        rtc.adjust(DateTime(epoch));
-        rtc.writeSqwPinMode(DS3231_SquareWave1Hz);
-        Serial.println(F("[RTC] set from UNIX epoch"));
+        ds3231SetTime(epoch);
+        timeWasSet(epoch);
+        uart.println(F("[RTC] set from UNIX epoch"));
         printRTC();
         return;
     }
-    Serial.println(F("Commands: RD | CT[=±offset] | T=YYYY-MM-DD HH:MM:SS | U=<unix_epoch>"));
-    Serial.println(F("CT offset examples: CT=+10  CT -45  CT=+01:02:03"));
+    uart.println(F("Commands: " TIME_COMMANDS_HELP));
+    uart.println(F("CT offset examples: CT=+10  CT -45  CT=+01:02:03"));
 }
 
 void timeCommandsHandle()
 {
-    static char buf[64];
-    static uint8_t idx = 0;
-    while (Serial.available())
+    PROF_SCOPE(PR_TIME_CMDS);
+    static uint16_t lastDropped = 0;
+    uint16_t dropped = serialLinesDropped();
+    if (dropped != lastDropped)
     {
-        char c = (char)Serial.read();
-        if (c == '\r' || c == '\n')
-        {
-            buf[idx] = 0;
-            idx = 0;
-            char *p = buf;
-            while (*p == ' ')
-                p++;
-            int n = strlen(p);
-            while (n > 0 && p[n - 1] == ' ')
-                p[--n] = 0;
-            if (*p)
-            {
-                for (char *q = p; *q && *q != ' ' && *q != '='; ++q)
-                    *q = toupper(*q);
-                processTimeCommand(p);
-            }
-        }
-        else if (idx < sizeof(buf) - 1)
-            buf[idx++] = c;
+        uart.print(F("[ERR] lines dropped (too long / too fast): "));
+        uart.println((uint16_t)(dropped - lastDropped));
+        lastDropped = dropped;
+    }
+    // Lines arrive trimmed with the command token upper-cased (serial_port RX ISR)
+    while (serialLineReady())
+    {
+        processTimeCommand(serialLinePeek());
+        serialLineRelease();
     }
 }
@@ -0,0 +1,72 @@
+#include "timebase.h"
+#include <util/atomic.h>
+#include "config.h"
+#include "debug.h"
+#include "globals.h"
+#include "ds3231.h"
+#include "cpu_clock.h"
+
+static bool g_resyncPending = true; // SQW count not seeded yet
+static uint32_t g_lastSyncEpoch = 0;
+
+// Per-wake cache for the non-SQW path
+static bool g_cacheValid = false;
+static uint32_t g_cacheEpoch = 0;
+static unsigned long g_cacheMs = 0;
+
+static uint32_t sqwEpoch()
+{
+    uint32_t e;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { e = g_app.sqwEpoch; }
+    return e;
+}
+
+static uint32_t cachedEpoch()
+{
+    if (!g_cacheValid)
+    {
+        ds3231ReadTimeStatus(&g_cacheEpoch); // time + alarm flags, one burst
+        g_cacheMs = cpuClockMillis();
+        g_cacheValid = true;
+    }
+    return g_cacheEpoch + (cpuClockMillis() - g_cacheMs) / 1000UL;
+}
+
+void timebaseSqwCounting(bool on)
+{
+    g_app.sqwCounting = on;
+    g_resyncPending = true;
+    g_cacheValid = false;
+}
+
+void timebaseOnSqwTick()
+{
+    if (!g_app.sqwCounting)
+        return;
+    if (!g_resyncPending && (uint32_t)(sqwEpoch() - g_lastSyncEpoch) < TIMEBASE_RESYNC_SEC)
+        return;
+    // Read just after the counted edge, so the read and later increments
+    // share the same phase of the 1 Hz output.
+    uint32_t e;
+    if (!ds3231ReadTimeStatus(&e))
+        return;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { g_app.sqwEpoch = e; }
+    g_lastSyncEpoch = e;
+    g_resyncPending = false;
+    DBG_LOG(LOG_TIME_RESYNC, e);
+}
+
+void timebaseInvalidate() { g_cacheValid = false; }
+
+void timebaseResync()
+{
+    g_resyncPending = true;
+    g_cacheValid = false;
+}
+
+uint32_t timebaseNow()
+{
+    if (g_app.sqwCounting && !g_resyncPending)
+        return sqwEpoch();
+    return cachedEpoch();
+}
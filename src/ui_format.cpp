@@ -1,31 +1,41 @@
 #include "ui_format.h"
+#include "cycle_profiler.h"
 #include "debug.h"
+#include "line_writer.h"
+#include "runtime_estimate.h"
 
-static void fmtFloatLocal(float v, uint8_t w, uint8_t p, char *out, size_t n)
+// Volts from millivolts with 0-2 decimals, rounded: 3874 -> "3.87" / "3.9" / "4"
+static LineWriter &putVolts(LineWriter &w, uint16_t mv, uint8_t decimals)
 {
-    dtostrf(v, w, p, out);
-    out[n - 1] = 0;
+    static const uint16_t kDiv[] = {1000, 100, 10};
+    return w.fixed((mv + kDiv[decimals] / 2u) / kDiv[decimals], decimals);
+}
+
+// Clock line 2 prefix: "DD/MM/YY " or "No RTC   " (9 chars)
+static LineWriter &putDate(LineWriter &w, bool haveRTC, const DateTime &now)
+{
+    if (haveRTC)
+        return w.num(now.day(), 2, '0').ch('/').num(now.month(), 2, '0').ch('/').num(now.year() % 100, 2, '0').ch(' ');
+    return w.str("No RTC   ");
 }
 
 void buildClockLines(bool haveRTC,
                      const DateTime &now,
                      unsigned long softSeconds,
-                     float vbat,
+                     uint16_t vbatMv,
                      char *line1, size_t l1n,
-                     char *line2, size_t l2n)
+                     char *line2, size_t l2n,
+                     bool showSeconds)
 {
+    PROF_SCOPE(PR_CLOCK_LINES);
     int hour12;
     bool pm = false;
     uint8_t mm, ss;
-    uint8_t day = 0, mon = 0, yy = 0;
     if (haveRTC)
     {
         int h = now.hour();
         mm = now.minute();
         ss = now.second();
-        day = now.day();
-        mon = now.month();
-        yy = now.year() % 100;
         if (h == 0)
             hour12 = 12;
         else if (h == 12)
@@ -63,70 +73,66 @@ void buildClockLines(bool haveRTC,
         else
             hour12 = h;
     }
-    char vb[8];
-    dtostrf(vbat, 1, 2, vb);
-    snprintf(line1, l1n, "%02d:%02u:%02u %s  Batt", hour12, mm, ss, pm ? "PM" : "AM");
-    if (haveRTC)
-    {
-        snprintf(line2, l2n, "%02u/%02u/%02u %sV %c", day, mon, yy, vb, batteryFlag(vbat));
-    }
+    LineWriter w1(line1, l1n);
+    w1.num(hour12, 2, '0').ch(':').num(mm, 2, '0');
+    if (showSeconds)
+        w1.ch(':').num(ss, 2, '0').str(pm ? " PM  Batt" : " AM  Batt");
     else
-    {
-        snprintf(line2, l2n, "No RTC   %sV %c", vb, batteryFlag(vbat));
-    }
+        w1.str(pm ? " PM    Batt" : " AM    Batt");
+    LineWriter w2(line2, l2n);
+    putDate(w2, haveRTC, now);
+    putVolts(w2, vbatMv, 2).str("V ").ch(batteryFlag(vbatMv));
 }
 
-void buildHygroLine1(float tc, float rh, char *line1, size_t n)
+void buildRuntimeLine2(bool haveRTC, const DateTime &now, uint16_t days,
+                       char batFlag, char *line2, size_t n)
 {
-    if (!isnan(rh) && !isnan(tc))
-    {
-        char tbuf[8];
-        fmtFloatLocal(tc, 4, 1, tbuf, sizeof(tbuf));
-        snprintf(line1, n, "%4s%cC  RH %2d%%", tbuf, DEGREE_CHAR, (int)round(rh));
-    }
+    // Same 7-char field as "3.87V F": " 123d F"
+    LineWriter w(line2, n);
+    putDate(w, haveRTC, now);
+    if (days == RUNTIME_UNKNOWN)
+        w.str("  --");
     else
-    {
-        snprintf(line1, n, "SENSOR ERROR");
-    }
+        w.num(days, 4);
+    w.str("d ").ch(batFlag);
+}
+
+void buildHygroLine1(int16_t tc10, int16_t rh10, char *line1, size_t n)
+{
+    PROF_SCOPE(PR_HYGRO_LINE1);
+    LineWriter w(line1, n);
+    if (rh10 != DHT22_NO_READING && tc10 != DHT22_NO_READING)
+        w.fixed(tc10, 1, 4).ch((char)DEGREE_CHAR).str("C  RH ").num((uint16_t)(rh10 + 5) / 10u, 2).ch('%');
+    else
+        w.str("SENSOR ERROR");
 }
 
 void buildHygroLine2(const char *elapsed, char rtcFlag,
-                     float vbat, char batFlag,
+                     uint16_t vbatMv, char batFlag,
                      char *line2, size_t n)
 {
-    int elen = strlen(elapsed);
-    char vbStr[10];
-    if (elen <= 7)
-    {
-        fmtFloatLocal(vbat, 4, 2, vbStr, sizeof(vbStr));
-        snprintf(line2, n, "E%s%c %sV%c", elapsed, rtcFlag, vbStr, batFlag);
-    }
-    else if (elen == 8)
-    {
-        fmtFloatLocal(vbat, 3, 1, vbStr, sizeof(vbStr));
-        snprintf(line2, n, "E%s%c %sV%c", elapsed, rtcFlag, vbStr, batFlag);
-    }
-    else
-    {
-        fmtFloatLocal(vbat, 1, 0, vbStr, sizeof(vbStr));
-        snprintf(line2, n, "E%s%c%sV%c", elapsed, rtcFlag, vbStr, batFlag);
-    }
+    PROF_SCOPE(PR_HYGRO_LINE2);
+    // Longer elapsed strings trade battery decimals for room
+    uint8_t elen = strlen(elapsed);
+    LineWriter w(line2, n);
+    w.ch('E').str(elapsed).ch(rtcFlag);
+    if (elen <= 8)
+        w.ch(' ');
+    putVolts(w, vbatMv, (elen <= 7) ? 2 : ((elen == 8) ? 1 : 0)).ch('V').ch(batFlag);
 }
 
 // Minutes-only elapsed (dHH:MM, no seconds) from TimeSpan
 void formatElapsed(const TimeSpan &ts, char *out, size_t n)
 {
     uint32_t mins = ts.totalseconds() / 60;
-    snprintf(out, n, "%lud%02u:%02u",
-             (unsigned long)(mins / (24u * 60u)),
-             (uint8_t)((mins / 60u) % 24u),
-             (uint8_t)(mins % 60u));
+    LineWriter w(out, n);
+    w.num(mins / (24u * 60u)).ch('d').num((mins / 60u) % 24u, 2, '0').ch(':').num(mins % 60u, 2, '0');
 }
 
 // Millis-based fallback (no RTC)
 void formatElapsedMillis(unsigned long ms, char *out, size_t n)
 {
     unsigned long m = (ms / 1000UL) / 60UL;
-    snprintf(out, n, "%lud%02lu:%02lu",
-             (unsigned long)(m / (24UL * 60UL)), (m / 60UL) % 24UL, m % 60UL);
+    LineWriter w(out, n);
+    w.num(m / (24UL * 60UL)).ch('d').num((m / 60UL) % 24UL, 2, '0').ch(':').num(m % 60UL, 2, '0');
 }
@@ -0,0 +1,119 @@
+#include "wake_stats.h"
+#include "config.h"
+#include "cpu_clock.h"
+#include "deadline.h"
+#include "event_queue.h"
+
+#if ENABLE_WAKE_STATS
+
+// Totals in ms plus a us remainder: a uint32_t of us wraps after 71 min,
+// which the 1.2 s serial windows alone reach in a few days
+struct MsTotal
+{
+    uint32_t ms;
+    uint16_t us;
+};
+
+static uint32_t g_wakes[WS_COUNT];
+static MsTotal g_awake[WS_COUNT];
+static uint32_t g_phaseCount[WP_COUNT];
+static MsTotal g_phase[WP_COUNT];
+static WakeSource g_src = WS_TIMER; // owner of the awake time since g_mark
+static bool g_claimed = true;       // a source has been counted for this wake (boot is not a wake)
+static uint32_t g_mark = 0;
+static uint32_t g_resetMs = 0;
+
+static const char kSrcNames[WS_COUNT][9] PROGMEM = {"timer", "tick", "alarm", "slide", "button", "serial", "failsafe"};
+static const char kPhaseNames[WP_COUNT][7] PROGMEM = {"dht", "adc", "lcd", "i2c", "serial"};
+
+static void addUs(MsTotal &t, uint32_t us)
+{
+    us += t.us;
+    t.ms += us / 1000;
+    t.us = (uint16_t)(us % 1000);
+}
+
+static void settle()
+{
+    uint32_t now = cpuClockMicros();
+    addUs(g_awake[g_src], now - g_mark);
+    g_mark = now;
+}
+
+void wakeStatsWake()
+{
+    settle();
+    if (!g_claimed)
+        g_wakes[WS_TIMER]++;
+    g_src = WS_TIMER;
+    g_claimed = false;
+}
+
+void wakeStatsSource(WakeSource s)
+{
+    g_wakes[s]++;
+    if (g_claimed && s != WS_FAILSAFE)
+        return;
+    settle();
+    g_src = s;
+    g_claimed = true;
+}
+
+uint32_t wakeStatsPhaseBegin() { return cpuClockMicros(); }
+
+void wakeStatsPhaseEnd(WakePhase p, uint32_t stamp, uint32_t missedUs)
+{
+    g_phaseCount[p]++;
+    addUs(g_phase[p], cpuClockMicros() - stamp + missedUs);
+    addUs(g_awake[g_src], missedUs);
+}
+
+void wakeStatsReset()
+{
+    memset(g_wakes, 0, sizeof(g_wakes));
+    memset(g_awake, 0, sizeof(g_awake));
+    memset(g_phaseCount, 0, sizeof(g_phaseCount));
+    memset(g_phase, 0, sizeof(g_phase));
+    g_mark = cpuClockMicros();
+    g_resetMs = deadlineNow();
+}
+
+void wakeStatsDump(Print &out)
+{
+    settle();
+    out.print(F("[ST] span_ms="));
+    out.println(deadlineNow() - g_resetMs);
+    for (uint8_t s = 0; s < WS_COUNT; s++)
+    {
+        out.print(F("[ST] wake "));
+        out.print((const __FlashStringHelper *)kSrcNames[s]);
+        out.print(F(" n="));
+        out.print(g_wakes[s]);
+        out.print(F(" awake_ms="));
+        out.println(g_awake[s].ms);
+    }
+    for (uint8_t p = 0; p < WP_COUNT; p++)
+    {
+        out.print(F("[ST] phase "));
+        out.print((const __FlashStringHelper *)kPhaseNames[p]);
+        out.print(F(" n="));
+        out.print(g_phaseCount[p]);
+        out.print(F(" ms="));
+        out.println(g_phase[p].ms);
+    }
+    out.print(F("[ST] events dropped="));
+    out.print(eventQueueDropped());
+    out.print(F(" max_latency_us="));
+    out.println(eventQueueMaxLatencyUs());
+}
+
+#else
+
+void wakeStatsWake() {}
+void wakeStatsSource(WakeSource) {}
+uint32_t wakeStatsPhaseBegin() { return 0; }
+void wakeStatsPhaseEnd(WakePhase, uint32_t, uint32_t) {}
+void wakeStatsReset() {}
+void wakeStatsDump(Print &out) { out.println(F("[ST] disabled (ENABLE_WAKE_STATS)")); }
+
+#endif
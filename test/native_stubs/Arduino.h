@@ -0,0 +1,29 @@
+#pragma once
+// Host stand-in for the Arduino core, just enough for the pure formatting
+// modules (ui_format, line_writer) under `pio test -e native`.
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PROGMEM
+#define pgm_read_byte(p) (*(const uint8_t *)(p))
+#define pgm_read_word(p) (*(const uint16_t *)(p))
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper *>(s))
+
+class Print
+{
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t) = 0;
+    virtual size_t write(const uint8_t *b, size_t n)
+    {
+        size_t r = 0;
+        while (n--)
+            r += write(*b++);
+        return r;
+    }
+    virtual int availableForWrite() { return 0; }
+    virtual void flush() {}
+};
@@ -0,0 +1,31 @@
+#pragma once
+// Host stand-in for RTClib: the DateTime / TimeSpan accessors ui_format uses.
+#include <stdint.h>
+
+class TimeSpan
+{
+public:
+    TimeSpan(int32_t s = 0) : s_(s) {}
+    int32_t totalseconds() const { return s_; }
+
+private:
+    int32_t s_;
+};
+
+class DateTime
+{
+public:
+    DateTime(uint16_t y, uint8_t m, uint8_t d, uint8_t hh = 0, uint8_t mm = 0, uint8_t ss = 0)
+        : y_(y), m_(m), d_(d), hh_(hh), mm_(mm), ss_(ss) {}
+    explicit DateTime(uint32_t = 0) : y_(2000), m_(1), d_(1), hh_(0), mm_(0), ss_(0) {}
+    uint16_t year() const { return y_; }
+    uint8_t month() const { return m_; }
+    uint8_t day() const { return d_; }
+    uint8_t hour() const { return hh_; }
+    uint8_t minute() const { return mm_; }
+    uint8_t second() const { return ss_; }
+
+private:
+    uint16_t y_;
+    uint8_t m_, d_, hh_, mm_, ss_;
+};
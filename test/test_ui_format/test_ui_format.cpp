@@ -0,0 +1,194 @@
+// Golden strings for the LCD formatters. Every expected value below was
+// produced by the integer-snprintf builders (tenths / millivolts, no
+// float) that LineWriter replaced, so a change here is a change on the
+// display.
+//   pio test -e native
+#include <unity.h>
+#include "ui_format.h"
+
+static char l1[17];
+static char l2[17];
+
+void setUp() {}
+void tearDown() {}
+
+struct Line1Case
+{
+    int16_t tc10;
+    int16_t rh10;
+    const char *expect;
+};
+
+static void test_hygro_line1()
+{
+    static const Line1Case cases[] = {
+        {-400, 0, "-40.0\337C  RH  0%"},
+        {-400, 95, "-40.0\337C  RH 10%"},
+        {-400, 999, "-40.0\337C  RH 100%"},
+        {-52, 4, "-5.2\337C  RH  0%"},
+        {-52, 994, "-5.2\337C  RH 99%"},
+        {-52, 1000, "-5.2\337C  RH 100%"},
+        {-5, 5, "-0.5\337C  RH  1%"},
+        {-5, 995, "-0.5\337C  RH 100%"},
+        {0, 0, " 0.0\337C  RH  0%"},
+        {0, 95, " 0.0\337C  RH 10%"},
+        {5, 4, " 0.5\337C  RH  0%"},
+        {5, 994, " 0.5\337C  RH 99%"},
+        {235, 5, "23.5\337C  RH  1%"},
+        {235, 995, "23.5\337C  RH 100%"},
+        {999, 0, "99.9\337C  RH  0%"},
+        {999, 999, "99.9\337C  RH 100%"},
+    };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    {
+        buildHygroLine1(cases[i].tc10, cases[i].rh10, l1, sizeof(l1));
+        TEST_ASSERT_EQUAL_STRING(cases[i].expect, l1);
+    }
+}
+
+static void test_hygro_line1_no_reading()
+{
+    buildHygroLine1(DHT22_NO_READING, 500, l1, sizeof(l1));
+    TEST_ASSERT_EQUAL_STRING("SENSOR ERROR", l1);
+    buildHygroLine1(235, DHT22_NO_READING, l1, sizeof(l1));
+    TEST_ASSERT_EQUAL_STRING("SENSOR ERROR", l1);
+}
+
+struct Line2Case
+{
+    const char *elapsed;
+    char rtcFlag;
+    uint16_t mv;
+    const char *expect;
+};
+
+// Elapsed widths 7 / 8 / 9 characters drop the volts to 2 / 1 / 0 decimals.
+static void test_hygro_line2()
+{
+    static const Line2Case cases[] = {
+        {"0d00:00", 'R', 0, "E0d00:00R 0.00V!"},
+        {"0d00:00", 'T', 3344, "E0d00:00T 3.34V!"},
+        {"0d00:00", 'T', 3345, "E0d00:00T 3.35V!"},
+        {"9d23:59", 'R', 3450, "E9d23:59R 3.45V!"},
+        {"9d23:59", 'R', 3875, "E9d23:59R 3.88VM"},
+        {"9d23:59", 'R', 3995, "E9d23:59R 4.00VM"},
+        {"9d23:59", 'R', 4005, "E9d23:59R 4.01VF"},
+        {"10d00:00", 'R', 0, "E10d00:00R 0.0V!"},
+        {"10d00:00", 'T', 3345, "E10d00:00T 3.3V!"},
+        {"10d00:00", 'R', 3449, "E10d00:00R 3.4V!"},
+        {"10d00:00", 'R', 3450, "E10d00:00R 3.5V!"},
+        {"99d23:59", 'R', 3875, "E99d23:59R 3.9VM"},
+        {"99d23:59", 'R', 3995, "E99d23:59R 4.0VM"},
+        {"99d23:59", 'R', 4005, "E99d23:59R 4.0VF"},
+        {"100d00:00", 'R', 0, "E100d00:00R0V!"},
+        {"100d00:00", 'T', 3450, "E100d00:00T3V!"},
+        {"100d00:00", 'R', 3875, "E100d00:00R4VM"},
+        {"100d00:00", 'R', 4005, "E100d00:00R4VF"},
+    };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    {
+        const Line2Case &c = cases[i];
+        buildHygroLine2(c.elapsed, c.rtcFlag, c.mv, batteryFlag(c.mv), l2, sizeof(l2));
+        TEST_ASSERT_EQUAL_STRING(c.expect, l2);
+    }
+}
+
+struct ClockCase
+{
+    bool haveRTC;
+    uint8_t hour;
+    unsigned long softSeconds;
+    uint16_t mv;
+    bool showSeconds;
+    const char *expect1;
+    const char *expect2;
+};
+
+static void test_clock_lines()
+{
+    static const ClockCase cases[] = {
+        {true, 0, 0, 3449, false, "12:05 AM    Batt", "09/01/26 3.45V !"},
+        {true, 0, 0, 3449, true, "12:05:07 AM  Bat", "09/01/26 3.45V !"},
+        {true, 1, 0, 3875, true, "01:05:07 AM  Bat", "09/01/26 3.88V M"},
+        {true, 11, 0, 4005, false, "11:05 AM    Batt", "09/01/26 4.01V F"},
+        {true, 12, 0, 3875, false, "12:05 PM    Batt", "09/01/26 3.88V M"},
+        {true, 12, 0, 3875, true, "12:05:07 PM  Bat", "09/01/26 3.88V M"},
+        {true, 13, 0, 4005, true, "01:05:07 PM  Bat", "09/01/26 4.01V F"},
+        {true, 23, 0, 3449, false, "11:05 PM    Batt", "09/01/26 3.45V !"},
+        {false, 0, 0, 3700, false, "12:00 AM    Batt", "No RTC   3.70V M"},
+        {false, 0, 0, 3700, true, "12:00:00 AM  Bat", "No RTC   3.70V M"},
+        {false, 0, 3599, 3700, true, "12:59:59 AM  Bat", "No RTC   3.70V M"},
+        {false, 0, 43199, 3700, true, "11:59:59 AM  Bat", "No RTC   3.70V M"},
+        {false, 0, 43200, 3700, false, "12:00 PM    Batt", "No RTC   3.70V M"},
+        {false, 0, 46800, 3700, true, "01:00:00 PM  Bat", "No RTC   3.70V M"},
+        {false, 0, 86399, 3700, true, "11:59:59 PM  Bat", "No RTC   3.70V M"},
+    };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    {
+        const ClockCase &c = cases[i];
+        DateTime now(2026, 1, 9, c.hour, 5, 7);
+        buildClockLines(c.haveRTC, now, c.softSeconds, c.mv, l1, sizeof(l1), l2, sizeof(l2), c.showSeconds);
+        TEST_ASSERT_EQUAL_STRING(c.expect1, l1);
+        TEST_ASSERT_EQUAL_STRING(c.expect2, l2);
+    }
+}
+
+static void test_format_elapsed()
+{
+    static const struct
+    {
+        int32_t seconds;
+        const char *expect;
+    } cases[] = {
+        {0, "0d00:00"},
+        {59, "0d00:00"},
+        {60, "0d00:01"},
+        {86399, "0d23:59"},
+        {9L * 86400 + 86340, "9d23:59"},
+        {10L * 86400, "10d00:00"},
+        {99L * 86400 + 86399, "99d23:59"},
+        {100L * 86400, "100d00:00"},
+    };
+    char buf[12];
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    {
+        formatElapsed(TimeSpan(cases[i].seconds), buf, sizeof(buf));
+        TEST_ASSERT_EQUAL_STRING(cases[i].expect, buf);
+    }
+}
+
+// millis() wraps after 49.7 days, so that is as far as this one goes.
+static void test_format_elapsed_millis()
+{
+    static const struct
+    {
+        uint32_t ms;
+        const char *expect;
+    } cases[] = {
+        {0UL, "0d00:00"},
+        {59999UL, "0d00:00"},
+        {60000UL, "0d00:01"},
+        {86399999UL, "0d23:59"},
+        {9UL * 86400000UL, "9d00:00"},
+        {10UL * 86400000UL, "10d00:00"},
+        {0xFFFFFFFFUL, "49d17:02"},
+    };
+    char buf[12];
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    {
+        formatElapsedMillis(cases[i].ms, buf, sizeof(buf));
+        TEST_ASSERT_EQUAL_STRING(cases[i].expect, buf);
+    }
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_hygro_line1);
+    RUN_TEST(test_hygro_line1_no_reading);
+    RUN_TEST(test_hygro_line2);
+    RUN_TEST(test_clock_lines);
+    RUN_TEST(test_format_elapsed);
+    RUN_TEST(test_format_elapsed_millis);
+    return UNITY_END();
+}
@@ -0,0 +1,150 @@
+#!/usr/bin/env python3
+"""Decode the firmware's tokenized debug log (include/debug_log.h).
+
+The message table is read from include/log_catalog.h. The firmware's
+[BOOT] record carries a hash of the catalog it was built from; a mismatch
+with the table read here is reported on stderr, since ids would then decode
+as the wrong messages (point --catalog at the matching checkout). Bytes
+outside records (serial command replies) are passed through as text.
+
+    python3 tools/log_decode.py capture.bin
+    python3 tools/log_decode.py --port /dev/ttyUSB0     # needs pyserial
+"""
+import argparse
+import datetime
+import os
+import re
+import struct
+import sys
+
+LOG_SYNC = 0x1E
+HERE = os.path.dirname(os.path.abspath(__file__))
+DEFAULT_CATALOG = os.path.join(HERE, "..", "include", "log_catalog.h")
+
+# specifier -> (struct format, size); %s is length-prefixed
+SPEC = {
+    "u": ("<H", 2),
+    "d": ("<h", 2),
+    "lu": ("<I", 4),
+    "ld": ("<i", 4),
+    "c": ("<c", 1),
+    "t": ("<I", 4),
+}
+SPEC_RE = re.compile(r"%(lu|ld|u|d|c|s|t|%)")
+
+
+def load_catalog(path):
+    with open(path) as f:
+        text = f.read()
+    text = text[text.index("#define LOG_CATALOG"):]  # skip the example in the header comment
+    entries = re.findall(r'X\(\s*(\w+)\s*,\s*"((?:[^"\\]|\\.)*)"\s*\)', text)
+    return [(name, fmt.encode().decode("unicode_escape")) for name, fmt in entries]
+
+
+def catalog_hash(catalog):
+    """FNV-1a as LOG_CATALOG_HASH in include/debug_log.h: last entry first."""
+    h = 2166136261
+    for name, fmt in reversed(catalog):
+        for b in name.encode() + b"\0" + fmt.encode("latin-1"):
+            h = ((h ^ b) * 16777619) & 0xFFFFFFFF
+    return h
+
+
+def decode_record(fmt, data, pos):
+    """Render fmt from data[pos:]; returns (text, new_pos) or None if short."""
+    out = []
+    last = 0
+    for m in SPEC_RE.finditer(fmt):
+        out.append(fmt[last:m.start()])
+        last = m.end()
+        spec = m.group(1)
+        if spec == "%":
+            out.append("%")
+            continue
+        if spec == "s":
+            if pos >= len(data) or pos + 1 + data[pos] > len(data):
+                return None
+            n = data[pos]
+            out.append(data[pos + 1:pos + 1 + n].decode("latin-1"))
+            pos += 1 + n
+            continue
+        sfmt, size = SPEC[spec]
+        if pos + size > len(data):
+            return None
+        (v,) = struct.unpack_from(sfmt, data, pos)
+        pos += size
+        if spec == "c":
+            out.append(v.decode("latin-1"))
+        elif spec == "t":
+            out.append(datetime.datetime.fromtimestamp(v, datetime.timezone.utc).strftime("%H:%M:%S") + " (%d)" % v)
+        else:
+            out.append(str(v))
+    out.append(fmt[last:])
+    return "".join(out), pos
+
+
+def decode(data, catalog, emit):
+    """Decode a complete buffer; returns the unconsumed tail (partial record)."""
+    pos = 0
+    text = bytearray()
+    while pos < len(data):
+        b = data[pos]
+        if b != LOG_SYNC:
+            text.append(b)
+            pos += 1
+            continue
+        if pos + 1 >= len(data):
+            break
+        ident = data[pos + 1]
+        if ident >= len(catalog):
+            pos += 1  # not a record start: resync on the next RS
+            continue
+        res = decode_record(catalog[ident][1], data, pos + 2)
+        if res is None:
+            break
+        if catalog[ident][0] == "LOG_BOOT":
+            (built,) = struct.unpack_from("<I", data, pos + 2)
+            if built != catalog_hash(catalog):
+                sys.stderr.write("warning: capture built from catalog %u, decoding with %u\n"
+                                 % (built, catalog_hash(catalog)))
+        if text:
+            emit(text.decode("latin-1"), raw=True)
+            text = bytearray()
+        emit(res[0])
+        pos = res[1]
+    if text:
+        emit(text.decode("latin-1"), raw=True)
+    return data[pos:]
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("capture", nargs="?", help="binary capture file (default: stdin)")
+    ap.add_argument("--port", help="read live from a serial port (pyserial)")
+    ap.add_argument("--baud", type=int, default=115200)
+    ap.add_argument("--catalog", default=DEFAULT_CATALOG)
+    args = ap.parse_args()
+
+    catalog = load_catalog(args.catalog)
+    if not catalog:
+        sys.exit("no entries in %s" % args.catalog)
+
+    def emit(s, raw=False):
+        sys.stdout.write(s if raw else s + "\n")
+        sys.stdout.flush()
+
+    if args.port:
+        import serial  # pyserial
+
+        tail = b""
+        with serial.Serial(args.port, args.baud, timeout=0.2) as port:
+            while True:
+                tail = decode(tail + port.read(256), catalog, emit)
+    else:
+        src = open(args.capture, "rb") if args.capture else sys.stdin.buffer
+        with src:
+            decode(src.read(), catalog, emit)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,135 @@
+#!/usr/bin/env python3
+"""Static RAM (.data + .bss) per module, from the linker map.
+
+As a PlatformIO extra script it adds -Map to the link, prints the report
+after every link and fails the build when the static total exceeds
+custom_ram_static_max (platformio.ini); the ELF is removed so the next
+build checks again. Standalone it reads a map file:
+
+    python3 tools/ram_report.py .pio/build/<env>/firmware.map --max 1536
+
+Only input sections kept by the linker are counted, so the figures are
+what the firmware really occupies. On AVR .rodata is copied to RAM and is
+counted as .data; PROGMEM data is not.
+"""
+import argparse
+import collections
+import os
+import re
+import sys
+
+RAM_SIZE = 2048  # ATmega328P
+DEFAULT_MAX = 1536  # leaves 512 bytes for the stack
+
+RAM_OUTPUT = (".data", ".bss", ".noinit")
+# " .bss.g_stats 0x00800234 0x78 path" (the name may stand on a line of its own)
+INPUT_RE = re.compile(r"^ (\.\S+|COMMON)(?:\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)\s+(\S.*))?$")
+CONT_RE = re.compile(r"^\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)\s+(\S.*)$")
+OUTPUT_RE = re.compile(r"^(\.\S+)\s")
+
+
+def module_name(path):
+    """'.../src/battery.cpp.o' -> 'battery', '.../libFoo.a(Bar.cpp.o)' -> 'Bar (Foo)'."""
+    m = re.match(r"(.*)\((.*)\)$", path)
+    archive = None
+    if m:
+        path, member = m.group(1), m.group(2)
+        archive = os.path.basename(path)
+        archive = re.sub(r"^lib|\.a$", "", archive)
+        path = member
+    name = os.path.basename(path)
+    name = re.sub(r"(\.(c|cpp|cc|S))?\.o$", "", name)
+    return "%s (%s)" % (name, archive) if archive else name
+
+
+def parse_map(text):
+    """Returns {module: [data, bss]} for input sections placed in RAM."""
+    usage = collections.defaultdict(lambda: [0, 0])
+    start = text.find("Linker script and memory map")
+    if start < 0:
+        raise ValueError("no memory map in this file (link with -Wl,-Map)")
+    out = None
+    pending = None
+    for line in text[start:].splitlines():
+        m = OUTPUT_RE.match(line)
+        if m:
+            out = m.group(1)
+            pending = None
+            continue
+        if out not in RAM_OUTPUT:
+            continue
+        if pending:
+            c = CONT_RE.match(line)
+            pending, name = None, pending
+            if c:
+                add(usage, out, name, int(c.group(2), 16), c.group(3))
+            continue
+        m = INPUT_RE.match(line)
+        if not m:
+            continue
+        if m.group(2) is None:
+            pending = m.group(1)
+        else:
+            add(usage, out, m.group(1), int(m.group(3), 16), m.group(4))
+    return usage
+
+
+def add(usage, out, name, size, path):
+    if size == 0 or name.startswith(".stab"):
+        return
+    usage[module_name(path.strip())][0 if out == ".data" else 1] += size
+
+
+def report(usage, limit, out=sys.stdout):
+    rows = sorted(usage.items(), key=lambda kv: -(kv[1][0] + kv[1][1]))
+    data = sum(v[0] for v in usage.values())
+    bss = sum(v[1] for v in usage.values())
+    total = data + bss
+    out.write("RAM (static) by module:\n")
+    out.write("  %-36s %6s %6s %6s\n" % ("module", "data", "bss", "total"))
+    for name, (d, b) in rows:
+        out.write("  %-36s %6d %6d %6d\n" % (name, d, b, d + b))
+    out.write("  %-36s %6d %6d %6d\n" % ("= all", data, bss, total))
+    out.write("  %d of %d bytes static, %d left for heap + stack (limit %d)\n"
+              % (total, RAM_SIZE, RAM_SIZE - total, limit))
+    if total > limit:
+        out.write("RAM budget exceeded: %d > custom_ram_static_max %d\n" % (total, limit))
+        return False
+    return True
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("map", help="linker map file")
+    ap.add_argument("--max", type=int, default=DEFAULT_MAX, help="fail above this many static bytes")
+    args = ap.parse_args()
+    with open(args.map) as f:
+        usage = parse_map(f.read())
+    return 0 if report(usage, args.max) else 1
+
+
+def scons_setup(env):
+    map_path = os.path.join(env.subst("$BUILD_DIR"), "firmware.map")
+    env.Append(LINKFLAGS=["-Wl,-Map," + map_path])
+    limit = int(env.GetProjectOption("custom_ram_static_max", DEFAULT_MAX))
+
+    def check(target, source, env):
+        with open(map_path) as f:
+            usage = parse_map(f.read())
+        if report(usage, limit):
+            return 0
+        os.remove(target[0].get_abspath())  # keep failing until fixed
+        return 1
+
+    env.AddPostAction("$BUILD_DIR/${PROGNAME}.elf", check)
+
+
+try:
+    Import("env")  # noqa: F821 - PlatformIO extra script
+except NameError:
+    env = None
+
+if env is not None:
+    scons_setup(env)
+elif __name__ == "__main__":
+    sys.exit(main())